@@ -0,0 +1,249 @@
+#include "FixtureServer.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+FixtureServer::~FixtureServer() { stop(); }
+
+void FixtureServer::addFile(const std::string &path, std::string body) {
+  m_files[path] = std::move(body);
+}
+
+std::string FixtureServer::baseUrl() const {
+  return "http://127.0.0.1:" + std::to_string(m_port);
+}
+
+void FixtureServer::resetCounters() {
+  m_bytesSent = 0;
+  m_requests = 0;
+  m_drops = 0;
+}
+
+int FixtureServer::start() {
+  m_listenFd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (m_listenFd < 0)
+    return 0;
+  int one = 1;
+  ::setsockopt(m_listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = 0;
+  if (::bind(m_listenFd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) <
+          0 ||
+      ::listen(m_listenFd, 128) < 0) {
+    ::close(m_listenFd);
+    m_listenFd = -1;
+    return 0;
+  }
+  socklen_t len = sizeof(addr);
+  ::getsockname(m_listenFd, reinterpret_cast<sockaddr *>(&addr), &len);
+  m_port = ntohs(addr.sin_port);
+
+  m_stopping = false;
+  m_acceptThread = std::thread(&FixtureServer::acceptLoop, this);
+  return m_port;
+}
+
+void FixtureServer::stop() {
+  if (m_listenFd < 0)
+    return;
+  m_stopping = true;
+  ::shutdown(m_listenFd, SHUT_RDWR);
+  if (m_acceptThread.joinable())
+    m_acceptThread.join();
+  ::close(m_listenFd);
+  m_listenFd = -1;
+
+  std::vector<std::thread> threads;
+  {
+    std::lock_guard<std::mutex> lk(m_connMtx);
+    for (int fd : m_connFds)
+      ::shutdown(fd, SHUT_RDWR);
+    threads.swap(m_connThreads);
+  }
+  for (auto &t : threads)
+    t.join();
+}
+
+void FixtureServer::acceptLoop() {
+  while (!m_stopping.load()) {
+    int fd = ::accept4(m_listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+    if (fd < 0) {
+      if (m_stopping.load())
+        break;
+      continue;
+    }
+    int one = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    std::lock_guard<std::mutex> lk(m_connMtx);
+    m_connFds.push_back(fd);
+    m_connThreads.emplace_back(&FixtureServer::serve, this, fd);
+  }
+}
+
+void FixtureServer::pace(size_t n) {
+  if (m_bandwidth <= 0)
+    return;
+  auto cost = std::chrono::nanoseconds(
+      static_cast<long long>(n * 1e9 / static_cast<double>(m_bandwidth)));
+  std::chrono::steady_clock::time_point at;
+  {
+    std::lock_guard<std::mutex> lk(m_paceMtx);
+    auto now = std::chrono::steady_clock::now();
+    at = std::max(now, m_nextSend);
+    m_nextSend = at + cost;
+  }
+  std::this_thread::sleep_until(at);
+}
+
+bool FixtureServer::shouldDrop(const std::string &path) {
+  if (m_dropEvery <= 0)
+    return false;
+  if (!m_dropPrefixes.empty() &&
+      std::none_of(m_dropPrefixes.begin(), m_dropPrefixes.end(),
+                   [&](const std::string &p) {
+                     return path.compare(0, p.size(), p) == 0;
+                   }))
+    return false;
+  return (m_bodies.fetch_add(1) + 1) % m_dropEvery == 0;
+}
+
+bool FixtureServer::sendAll(int fd, const char *data, size_t len) {
+  while (len > 0) {
+    ssize_t n = ::send(fd, data, len, MSG_NOSIGNAL);
+    if (n <= 0)
+      return false;
+    data += n;
+    len -= static_cast<size_t>(n);
+    m_bytesSent.fetch_add(n);
+  }
+  return true;
+}
+
+// "bytes=N-" ya da "bytes=N-M"
+static bool parseRange(const std::string &value, size_t size, size_t &from,
+                       size_t &to) {
+  if (value.compare(0, 6, "bytes=") != 0)
+    return false;
+  auto dash = value.find('-', 6);
+  if (dash == std::string::npos)
+    return false;
+  try {
+    from = std::stoull(value.substr(6, dash - 6));
+    std::string end = value.substr(dash + 1);
+    to = end.empty() ? size - 1 : std::min<size_t>(std::stoull(end), size - 1);
+  } catch (...) {
+    return false;
+  }
+  return true;
+}
+
+void FixtureServer::serve(int fd) {
+  std::string buf;
+  char chunk[8192];
+  for (;;) {
+    // İstek başlığını oku
+    size_t headerEnd;
+    while ((headerEnd = buf.find("\r\n\r\n")) == std::string::npos) {
+      ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+      if (n <= 0)
+        goto done;
+      buf.append(chunk, static_cast<size_t>(n));
+    }
+    std::string head = buf.substr(0, headerEnd);
+    buf.erase(0, headerEnd + 4);
+    m_requests.fetch_add(1);
+
+    std::istringstream is(head);
+    std::string method, target, version, line;
+    is >> method >> target >> version;
+    std::getline(is, line);
+    std::string range;
+    bool close = false;
+    while (std::getline(is, line)) {
+      if (!line.empty() && line.back() == '\r')
+        line.pop_back();
+      auto colon = line.find(':');
+      if (colon == std::string::npos)
+        continue;
+      std::string key = line.substr(0, colon);
+      std::transform(key.begin(), key.end(), key.begin(), ::tolower);
+      std::string value = line.substr(colon + 1);
+      value.erase(0, value.find_first_not_of(' '));
+      if (key == "range")
+        range = value;
+      else if (key == "connection" && value == "close")
+        close = true;
+    }
+    auto q = target.find('?');
+    if (q != std::string::npos)
+      target.resize(q);
+
+    if (m_latency.count() > 0)
+      std::this_thread::sleep_for(m_latency);
+
+    auto it = m_files.find(target);
+    std::ostringstream hdr;
+    size_t from = 0, to = 0;
+    const std::string *body = nullptr;
+    if (it == m_files.end()) {
+      hdr << "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n";
+    } else if (!range.empty() && !it->second.empty() &&
+               parseRange(range, it->second.size(), from, to) &&
+               from < it->second.size()) {
+      body = &it->second;
+      hdr << "HTTP/1.1 206 Partial Content\r\nContent-Range: bytes " << from
+          << "-" << to << "/" << it->second.size()
+          << "\r\nContent-Length: " << (to - from + 1) << "\r\n";
+    } else if (!range.empty() && !it->second.empty() &&
+               from >= it->second.size()) {
+      hdr << "HTTP/1.1 416 Range Not Satisfiable\r\nContent-Range: bytes */"
+          << it->second.size() << "\r\nContent-Length: 0\r\n";
+    } else {
+      body = &it->second;
+      to = it->second.empty() ? 0 : it->second.size() - 1;
+      hdr << "HTTP/1.1 200 OK\r\nContent-Length: " << it->second.size()
+          << "\r\nAccept-Ranges: bytes\r\n";
+    }
+    hdr << "Connection: " << (close ? "close" : "keep-alive") << "\r\n\r\n";
+    std::string h = hdr.str();
+    if (!sendAll(fd, h.data(), h.size()))
+      break;
+
+    if (body && method != "HEAD" && !body->empty()) {
+      // Kesilecekse gövdenin yalnızca ilk yarısı gider
+      bool drop = shouldDrop(target);
+      size_t end = drop ? from + (to - from + 1) / 2 : to + 1;
+      size_t pos = from;
+      while (pos < end) {
+        size_t n = std::min<size_t>(16384, end - pos);
+        pace(n);
+        if (!sendAll(fd, body->data() + pos, n))
+          goto done;
+        pos += n;
+      }
+      if (drop) {
+        m_drops.fetch_add(1);
+        goto done;
+      }
+    }
+    if (close)
+      break;
+  }
+done:
+  {
+    std::lock_guard<std::mutex> lk(m_connMtx);
+    m_connFds.erase(std::remove(m_connFds.begin(), m_connFds.end(), fd),
+                    m_connFds.end());
+  }
+  ::close(fd);
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Ağ erişimi olmadan kurulum hattını ölçmek için süreç içi HTTP/1.1
+// sunucusu. Dosyalar bellekten sunulur; keep-alive, HEAD ve Range
+// desteklenir. İstek başına gecikme, tüm bağlantılar arasında paylaşılan
+// bant genişliği sınırı ve gövde ortasında bağlantı kesme (devam ettirme ve
+// yeniden deneme yolları için) ayarlanabilir. Yalnızca POSIX.
+class FixtureServer {
+public:
+  FixtureServer() = default;
+  ~FixtureServer();
+
+  // Sunucu başlamadan önce doldurulur
+  void addFile(const std::string &path, std::string body);
+
+  void setLatency(std::chrono::milliseconds perRequest) {
+    m_latency = perRequest;
+  }
+  void setBandwidth(long long bytesPerSec) { m_bandwidth = bytesPerSec; }
+  // Her everyN. gövdeli yanıtta gövdenin yarısı gönderilip bağlantı
+  // kesilir (0: kapalı). prefixes boş değilse yalnızca bu öneklerle
+  // başlayan yollar kesilir.
+  void setDropMidBody(int everyN, std::vector<std::string> prefixes = {}) {
+    m_dropEvery = everyN;
+    m_dropPrefixes = std::move(prefixes);
+  }
+
+  // 127.0.0.1'de boş bir porta bağlanır; port döner (hata: 0)
+  int start();
+  void stop();
+
+  int port() const { return m_port; }
+  std::string baseUrl() const;
+
+  long long bytesSent() const { return m_bytesSent.load(); }
+  long long requests() const { return m_requests.load(); }
+  long long drops() const { return m_drops.load(); }
+  void resetCounters();
+
+private:
+  void acceptLoop();
+  void serve(int fd);
+  bool sendAll(int fd, const char *data, size_t len);
+  void pace(size_t n);
+  bool shouldDrop(const std::string &path);
+
+  std::map<std::string, std::string> m_files;
+  std::chrono::milliseconds m_latency{0};
+  long long m_bandwidth = 0; // 0: sınırsız
+  int m_dropEvery = 0;
+  std::vector<std::string> m_dropPrefixes;
+  std::atomic<long long> m_bodies{0}; // Kesilebilir gövdeli yanıt sayacı
+
+  int m_listenFd = -1;
+  int m_port = 0;
+  std::atomic<bool> m_stopping{false};
+  std::thread m_acceptThread;
+
+  std::mutex m_connMtx;
+  std::vector<int> m_connFds;
+  std::vector<std::thread> m_connThreads;
+
+  // Paylaşılan bant: bir sonraki baytın gönderilebileceği an
+  std::mutex m_paceMtx;
+  std::chrono::steady_clock::time_point m_nextSend{};
+
+  std::atomic<long long> m_bytesSent{0};
+  std::atomic<long long> m_requests{0};
+  std::atomic<long long> m_drops{0};
+};
@@ -0,0 +1,464 @@
+// Uçtan uca kurulum benchmark'ı. Süreç içi FixtureServer sentetik bir
+// sürüm manifesti, sürüm JSON'u, varlık dizini, istemci jar'ı, kütüphaneler
+// ve varlık nesneleri sunar; upstream URL'leri <mcDir>/mirrors.json ile
+// yerel sunucuya yönlendirilir. Ayna tablosu yalnızca-ayna kipindedir:
+// upstream aday olmaz, gecikme ölçülmez; koşular ağsız ve tekrarlanabilir.
+// LauncherCore::installVersion dört senaryoda sürülür:
+//   cold    – boş oyun dizini
+//   warm    – her şey mevcut (delta kontrolü)
+//   partial – varlıkların bir kısmı silinmiş/bozulmuş, istemci jar'ı yok
+//   stress  – çok sayıda küçük varlıklı ayrı bir sürüm, boş dizine
+// Her senaryo için duvar saati, alınan bayt, hız, tepe RSS ve main
+// thread olay döngüsünün en uzun duraklaması raporlanır. stress'te bu
+// duraklama bir kareyi (16 ms) aşarsa çıkış kodu 3 olur.
+//
+//   mixlauncher_bench [--assets N] [--libs N] [--jar-mb N]
+//                     [--latency-ms N] [--bandwidth-mbps N]
+//                     [--partial-pct N] [--keep-store] [--dir PATH]
+//                     [--no-io-uring] [--stress-assets N]
+//                     [--drop-every N]
+//
+// --drop-every N ile indirilen dosyaların (varlık, kütüphane, jar) her
+// N. yanıtı gövdenin ortasında kesilir: devam ettirme ve yeniden deneme
+// yolları ölçülür. Meta veri istekleri kesilmez.
+//
+// --dir ile oyun dizini farklı disklere (NVMe, ağ üzerindeki ev dizini)
+// konularak io_uring yazıcısı açık/kapalı karşılaştırılabilir. Benchmark
+// PATH altında kendine ait yeni bir alt dizin (mixlauncher-bench-XXXXXX)
+// açar ve çıkışta yalnızca onu siler; PATH'in mevcut içeriğine dokunmaz.
+
+#include "FixtureServer.h"
+#include "LauncherCore.h"
+#include "MirrorTable.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QTimer>
+
+#include <nlohmann/json.hpp>
+#include <openssl/evp.h>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+using json = nlohmann::json;
+namespace fs = std::filesystem;
+
+namespace {
+
+const char *kVersionId = "bench-1.0";
+const char *kStressVersionId = "bench-stress";
+constexpr double kFrameMs = 16.0; // 60 Hz'de bir kare
+
+struct Options {
+  int assets = 3000;
+  int libs = 60;
+  int jarMb = 24;
+  int latencyMs = 20;
+  double bandwidthMbps = 0; // 0: sınırsız
+  int partialPct = 10;
+  bool keepStore = false; // partial senaryosunda içerik deposunu koru
+  std::string dir;
+  bool ioUring = true;
+  int stressAssets = 20000;
+  int dropEvery = 0; // 0: yanıt kesilmez
+};
+
+std::string sha1Hex(const std::string &data) {
+  unsigned char hash[EVP_MAX_MD_SIZE];
+  unsigned int hlen = 0;
+  EVP_Digest(data.data(), data.size(), hash, &hlen, EVP_sha1(), nullptr);
+  std::ostringstream ss;
+  for (unsigned int i = 0; i < hlen; ++i)
+    ss << std::hex << std::setfill('0') << std::setw(2) << (int)hash[i];
+  return ss.str();
+}
+
+std::string randomBlob(std::mt19937_64 &rng, size_t size) {
+  std::string s(size, '\0');
+  for (size_t i = 0; i < size; i += 8) {
+    uint64_t v = rng();
+    std::memcpy(&s[i], &v, std::min<size_t>(8, size - i));
+  }
+  return s;
+}
+
+// Gerçek sürüm verilerinin şeklini taklit eden sabit tohumlu fikstür
+void buildFixture(FixtureServer &srv, const Options &opt) {
+  std::mt19937_64 rng(1234);
+
+  // Varlıklar: çoğu küçük (ses/doku), birkaç büyük
+  json objects = json::object();
+  std::uniform_int_distribution<int> small(300, 64 * 1024);
+  std::uniform_int_distribution<int> large(256 * 1024, 2 * 1024 * 1024);
+  for (int i = 0; i < opt.assets; ++i) {
+    size_t size = (i % 50 == 0) ? large(rng) : small(rng);
+    std::string blob = randomBlob(rng, size);
+    std::string hash = sha1Hex(blob);
+    objects["minecraft/bench/" + std::to_string(i)] = {{"hash", hash},
+                                                       {"size", size}};
+    srv.addFile("/resources/" + hash.substr(0, 2) + "/" + hash,
+                std::move(blob));
+  }
+  std::string assetIndex = json{{"objects", objects}}.dump();
+  std::string assetIndexSha = sha1Hex(assetIndex);
+  size_t assetIndexSize = assetIndex.size();
+  srv.addFile("/meta/v1/packages/bench-assets.json", std::move(assetIndex));
+
+  // Kütüphaneler
+  json libraries = json::array();
+  std::uniform_int_distribution<int> libSize(20 * 1024, 2 * 1024 * 1024);
+  for (int i = 0; i < opt.libs; ++i) {
+    std::string blob = randomBlob(rng, libSize(rng));
+    std::string path = "org/bench/lib" + std::to_string(i) + "/1.0/lib" +
+                       std::to_string(i) + "-1.0.jar";
+    libraries.push_back(
+        {{"name", "org.bench:lib" + std::to_string(i) + ":1.0"},
+         {"downloads",
+          {{"artifact",
+            {{"path", path},
+             {"url", "https://libraries.minecraft.net/" + path},
+             {"sha1", sha1Hex(blob)},
+             {"size", blob.size()}}}}}});
+    srv.addFile("/libraries/" + path, std::move(blob));
+  }
+
+  // İstemci jar'ı
+  std::string jar = randomBlob(rng, static_cast<size_t>(opt.jarMb) << 20);
+  json client = {
+      {"url", "https://piston-data.mojang.com/v1/objects/bench/client.jar"},
+      {"sha1", sha1Hex(jar)},
+      {"size", jar.size()}};
+  srv.addFile("/data/v1/objects/bench/client.jar", std::move(jar));
+
+  json version = {
+      {"id", kVersionId},
+      {"type", "release"},
+      {"mainClass", "net.minecraft.client.main.Main"},
+      {"assetIndex",
+       {{"id", "bench"},
+        {"url", "https://piston-meta.mojang.com/v1/packages/bench-assets.json"},
+        {"sha1", assetIndexSha},
+        {"size", assetIndexSize}}},
+      {"downloads", {{"client", client}}},
+      {"libraries", libraries}};
+  srv.addFile("/meta/v1/packages/" + std::string(kVersionId) + ".json",
+              version.dump());
+
+  // stress sürümü: çok sayıda küçük varlık, kütüphane yok, küçük jar.
+  // Main thread'in dosya başına işi (ilerleme, tamamlanma) öne çıkar.
+  json stressObjects = json::object();
+  std::uniform_int_distribution<int> tiny(64, 2048);
+  for (int i = 0; i < opt.stressAssets; ++i) {
+    std::string blob = randomBlob(rng, tiny(rng));
+    std::string hash = sha1Hex(blob);
+    stressObjects["minecraft/stress/" + std::to_string(i)] = {
+        {"hash", hash}, {"size", blob.size()}};
+    srv.addFile("/resources/" + hash.substr(0, 2) + "/" + hash,
+                std::move(blob));
+  }
+  std::string stressIndex = json{{"objects", stressObjects}}.dump();
+  std::string stressJar = randomBlob(rng, 64 * 1024);
+  json stressVersion = {
+      {"id", kStressVersionId},
+      {"type", "release"},
+      {"mainClass", "net.minecraft.client.main.Main"},
+      {"assetIndex",
+       {{"id", "stress"},
+        {"url",
+         "https://piston-meta.mojang.com/v1/packages/stress-assets.json"},
+        {"sha1", sha1Hex(stressIndex)},
+        {"size", stressIndex.size()}}},
+      {"downloads",
+       {{"client",
+         {{"url",
+           "https://piston-data.mojang.com/v1/objects/stress/client.jar"},
+          {"sha1", sha1Hex(stressJar)},
+          {"size", stressJar.size()}}}}},
+      {"libraries", json::array()}};
+  srv.addFile("/meta/v1/packages/stress-assets.json", std::move(stressIndex));
+  srv.addFile("/data/v1/objects/stress/client.jar", std::move(stressJar));
+  srv.addFile("/meta/v1/packages/" + std::string(kStressVersionId) + ".json",
+              stressVersion.dump());
+
+  auto entry = [](const char *id) {
+    return json{{"id", id},
+                {"type", "release"},
+                {"url", "https://piston-meta.mojang.com/v1/packages/" +
+                            std::string(id) + ".json"}};
+  };
+  json manifest = {
+      {"latest", {{"release", kVersionId}, {"snapshot", kVersionId}}},
+      {"versions", {entry(kVersionId), entry(kStressVersionId)}}};
+  srv.addFile("/meta/mc/game/version_manifest_v2.json", manifest.dump());
+}
+
+void writeMirrors(const std::string &mcDir, const std::string &base) {
+  json mirrors = {
+      {"https://piston-meta.mojang.com/", {base + "/meta/"}},
+      {"https://piston-data.mojang.com/", {base + "/data/"}},
+      {"https://libraries.minecraft.net/", {base + "/libraries/"}},
+      {"https://resources.download.minecraft.net/", {base + "/resources/"}}};
+  std::ofstream(mcDir + "/mirrors.json") << mirrors.dump(2);
+}
+
+// parent altında benzersiz, yeni bir dizin; çıkışta (hata yolları dahil)
+// silinir. Benchmark yalnızca kendi oluşturduğu dizini temizler.
+struct RunDir {
+  std::string path;
+
+  explicit RunDir(const std::string &parent) {
+    std::error_code ec;
+    fs::create_directories(parent, ec);
+    std::string tmpl = parent + "/mixlauncher-bench-XXXXXX";
+    if (::mkdtemp(tmpl.data()))
+      path = tmpl;
+  }
+  ~RunDir() {
+    std::error_code ec;
+    if (!path.empty())
+      fs::remove_all(path, ec);
+  }
+  RunDir(const RunDir &) = delete;
+  RunDir &operator=(const RunDir &) = delete;
+};
+
+// Tepe RSS (KiB). Linux'ta her senaryodan önce sıfırlanır.
+void resetPeakRss() { std::ofstream("/proc/self/clear_refs") << "5"; }
+
+long peakRssKb() {
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line))
+    if (line.compare(0, 6, "VmHWM:") == 0)
+      return std::atol(line.c_str() + 6);
+  return -1;
+}
+
+// Varlıkların bir kısmını sil ya da boz, istemci jar'ını kaldır
+int damageInstall(const std::string &mcDir, int pct) {
+  std::vector<fs::path> objects;
+  for (auto &e : fs::recursive_directory_iterator(mcDir + "/assets/objects"))
+    if (e.is_regular_file())
+      objects.push_back(e.path());
+  std::sort(objects.begin(), objects.end());
+  int damaged = 0;
+  for (size_t i = 0; i < objects.size(); ++i) {
+    if (static_cast<int>(i % 100) >= pct)
+      continue;
+    if (i % 2 == 0) {
+      fs::remove(objects[i]);
+    } else {
+      fs::remove(objects[i]); // Hardlink'i kopmuş yeni dosya olarak boz
+      std::ofstream(objects[i], std::ios::binary) << "bozuk";
+    }
+    ++damaged;
+  }
+  fs::remove(mcDir + "/versions/" + kVersionId + "/" + kVersionId + ".jar");
+  return damaged + 1;
+}
+
+struct Result {
+  bool ok = false;
+  double seconds = 0.0;
+  long long bytes = 0;
+  long rssKb = 0;
+  double maxStallMs = 0.0; // main thread olay döngüsünün en uzun duraklaması
+  long long drops = 0;     // Ortasında kesilen yanıtlar
+};
+
+Result runInstall(LauncherCore &core, FixtureServer &srv,
+                  const char *versionId = kVersionId) {
+  srv.resetCounters();
+  resetPeakRss();
+
+  Result r;
+  // 1 ms'lik zamanlayıcı: iki tık arası, olay döngüsünün bloklandığı süre
+  QTimer tick;
+  tick.setTimerType(Qt::PreciseTimer);
+  tick.setInterval(1);
+  QElapsedTimer sinceTick;
+  QObject::connect(&tick, &QTimer::timeout, [&] {
+    if (sinceTick.isValid())
+      r.maxStallMs = std::max(r.maxStallMs, sinceTick.nsecsElapsed() / 1e6);
+    sinceTick.start();
+  });
+  tick.start();
+
+  QEventLoop loop;
+  auto conn = QObject::connect(&core, &LauncherCore::installFinished, &loop,
+                               [&](bool ok, QString msg) {
+                                 r.ok = ok;
+                                 if (!ok)
+                                   std::fprintf(stderr, "  hata: %s\n",
+                                                qPrintable(msg));
+                                 loop.quit();
+                               });
+  auto t0 = std::chrono::steady_clock::now();
+  core.installVersion(versionId);
+  loop.exec();
+  tick.stop();
+  r.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                            t0)
+                  .count();
+  QObject::disconnect(conn);
+  r.bytes = srv.bytesSent();
+  r.drops = srv.drops();
+  r.rssKb = peakRssKb();
+  return r;
+}
+
+void report(const char *name, const Result &r) {
+  double mb = r.bytes / 1048576.0;
+  std::printf("%-8s %-4s %9.3f s %10.1f MB %9.1f MB/s %9.1f MB %8.1f ms\n",
+              name, r.ok ? "ok" : "HATA", r.seconds, mb,
+              r.seconds > 0 ? mb / r.seconds : 0.0, r.rssKb / 1024.0,
+              r.maxStallMs);
+  if (r.drops > 0)
+    std::printf("         (%lld yanit ortasinda kesildi)\n", r.drops);
+}
+
+Options parseArgs(int argc, char **argv) {
+  Options o;
+  for (int i = 1; i < argc; ++i) {
+    std::string a = argv[i];
+    auto next = [&]() -> const char * {
+      return i + 1 < argc ? argv[++i] : "0";
+    };
+    if (a == "--assets")
+      o.assets = std::atoi(next());
+    else if (a == "--libs")
+      o.libs = std::atoi(next());
+    else if (a == "--jar-mb")
+      o.jarMb = std::atoi(next());
+    else if (a == "--latency-ms")
+      o.latencyMs = std::atoi(next());
+    else if (a == "--bandwidth-mbps")
+      o.bandwidthMbps = std::atof(next());
+    else if (a == "--partial-pct")
+      o.partialPct = std::atoi(next());
+    else if (a == "--keep-store")
+      o.keepStore = true;
+    else if (a == "--dir")
+      o.dir = next();
+    else if (a == "--no-io-uring")
+      o.ioUring = false;
+    else if (a == "--stress-assets")
+      o.stressAssets = std::atoi(next());
+    else if (a == "--drop-every")
+      o.dropEvery = std::atoi(next());
+  }
+  return o;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  QCoreApplication app(argc, argv);
+  Options opt = parseArgs(argc, argv);
+  spdlog::set_level(spdlog::level::warn);
+  std::cout.setstate(std::ios::failbit); // [INDIR] satırlarını sustur
+
+  FixtureServer srv;
+  std::fprintf(stderr, "Fikstur hazirlaniyor (%d varlik, %d kutuphane, "
+                       "%d MB jar, stress %d varlik)...\n",
+               opt.assets, opt.libs, opt.jarMb, opt.stressAssets);
+  buildFixture(srv, opt);
+  srv.setLatency(std::chrono::milliseconds(opt.latencyMs));
+  srv.setBandwidth(static_cast<long long>(opt.bandwidthMbps * 1e6 / 8));
+  // Meta veri tek denemeyle alınır; yalnızca indirme hattı kesilir
+  srv.setDropMidBody(opt.dropEvery, {"/resources/", "/libraries/", "/data/"});
+  if (!srv.start()) {
+    std::fprintf(stderr, "Sunucu baslatilamadi\n");
+    return 1;
+  }
+
+  // LauncherCore'dan önce kurulur, ondan sonra silinir
+  RunDir runDir(opt.dir.empty() ? fs::temp_directory_path().string()
+                                : opt.dir);
+  if (runDir.path.empty()) {
+    std::fprintf(stderr, "Calisma dizini olusturulamadi\n");
+    return 1;
+  }
+  const std::string &mcDir = runDir.path;
+  writeMirrors(mcDir, srv.baseUrl());
+
+  // LauncherCore kurulurken okunur
+  if (!opt.ioUring)
+    ::setenv("MIXLAUNCHER_IO_URING", "0", 1);
+  MirrorTable::instance().setMirrorsOnly(true);
+
+  int rc = 0;
+  {
+    LauncherCore core(QString::fromStdString(mcDir));
+
+    // Manifest (sürüm listesi) yüklensin
+    QEventLoop loop;
+    QObject::connect(&core, &LauncherCore::versionsReady, &loop,
+                     &QEventLoop::quit);
+    QTimer::singleShot(15000, &loop, &QEventLoop::quit);
+    core.fetchVersionManifest();
+    loop.exec();
+    if (core.cachedVersions().empty()) {
+      std::fprintf(stderr, "Manifest alinamadi\n");
+      return 1;
+    }
+
+    std::printf("gecikme %d ms, bant %s, io_uring %s, kesme %s\n",
+                opt.latencyMs,
+                opt.bandwidthMbps > 0
+                    ? (std::to_string(opt.bandwidthMbps) + " Mbit/s").c_str()
+                    : "sinirsiz",
+                opt.ioUring ? "acik" : "kapali",
+                opt.dropEvery > 0
+                    ? ("her " + std::to_string(opt.dropEvery) + ". yanit")
+                          .c_str()
+                    : "yok");
+    std::printf("%-8s %-4s %11s %13s %14s %12s %11s\n", "senaryo", "",
+                "sure", "alinan", "hiz", "tepe RSS", "en uzun dur");
+
+    Result cold = runInstall(core, srv);
+    report("cold", cold);
+    Result warm = runInstall(core, srv);
+    report("warm", warm);
+
+    int damaged = damageInstall(mcDir, opt.partialPct);
+    if (!opt.keepStore)
+      fs::remove_all(mcDir + "/store");
+    Result partial = runInstall(core, srv);
+    report("partial", partial);
+    std::printf("(partial: %d dosya eksik/bozuk, icerik deposu %s)\n",
+                damaged, opt.keepStore ? "korundu" : "silindi");
+
+    Result stress = runInstall(core, srv, kStressVersionId);
+    report("stress", stress);
+    bool smooth = stress.maxStallMs < kFrameMs;
+    std::printf("(stress: %d varlik, main thread en uzun %.1f ms durdu, "
+                "sinir %.0f ms: %s)\n",
+                opt.stressAssets, stress.maxStallMs, kFrameMs,
+                smooth ? "gecti" : "KALDI");
+
+    core.dumpMetrics(QString::fromStdString(mcDir + "/logs/metrics.json"));
+    rc = cold.ok && warm.ok && partial.ok && stress.ok ? 0 : 2;
+    if (rc == 0 && !smooth)
+      rc = 3;
+  }
+
+  srv.stop();
+  return rc;
+}
@@ -0,0 +1,279 @@
+// Görev kuyruğu seçiminin tekrarlanabilir ölçümü: DownloadManager'ın
+// kullandığı TaskQueue (sınıf başına deque, tek mutex + cv) ile sınıf
+// başına kilitsiz halka + park eden tüketiciler. İndirme hattındaki gibi:
+// bir üretici toplu kuyruklar, N işçi öğeleri alır; her öğenin küçük bir
+// kısmı bir sonraki aşamaya (aynı kuyruğa) geri itilir.
+//
+//   mixlauncher_queue_bench [öğe_sayısı]
+//
+// Halka, ortak bir öğe sayacı olmadan (boşluk halkaların indekslerinden
+// okunur) ölçülür. Ölçülebilir bir kazanç göstermediğinden üretimde mutex
+// kuyruğu kullanılır.
+
+#include "TaskQueue.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr int kClasses = 3;
+
+struct Item {
+  int cls = 0;
+  int hops = 0; // >0 ise işlendikten sonra yeniden kuyruğa girer
+};
+using ItemPtr = std::shared_ptr<Item>;
+
+// Sınırlı, kilitsiz çok üretici / çok tüketici halka (D. Vyukov).
+// Her hücrenin sıra numarası, hücrenin yazılmaya mı okunmaya mı hazır
+// olduğunu söyler; üretici ve tüketiciler yalnızca kendi indekslerinde
+// CAS yapar, birbirlerini kilitlemez.
+template <class T> class MpmcRing {
+public:
+  explicit MpmcRing(size_t capacity) {
+    size_t cap = 2;
+    while (cap < capacity)
+      cap <<= 1;
+    m_mask = cap - 1;
+    m_cells.reset(new Cell[cap]);
+    for (size_t i = 0; i < cap; ++i)
+      m_cells[i].seq.store(i, std::memory_order_relaxed);
+  }
+
+  MpmcRing(const MpmcRing &) = delete;
+  MpmcRing &operator=(const MpmcRing &) = delete;
+
+  // Halka doluysa false
+  bool tryPush(T &value) {
+    size_t pos = m_enqueue.load(std::memory_order_relaxed);
+    Cell *cell;
+    for (;;) {
+      cell = &m_cells[pos & m_mask];
+      size_t seq = cell->seq.load(std::memory_order_acquire);
+      auto dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+      if (dif == 0) {
+        if (m_enqueue.compare_exchange_weak(pos, pos + 1,
+                                            std::memory_order_relaxed))
+          break;
+      } else if (dif < 0) {
+        return false;
+      } else {
+        pos = m_enqueue.load(std::memory_order_relaxed);
+      }
+    }
+    cell->data = std::move(value);
+    cell->seq.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Halka boşsa false
+  bool tryPop(T &out) {
+    size_t pos = m_dequeue.load(std::memory_order_relaxed);
+    Cell *cell;
+    for (;;) {
+      cell = &m_cells[pos & m_mask];
+      size_t seq = cell->seq.load(std::memory_order_acquire);
+      auto dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+      if (dif == 0) {
+        if (m_dequeue.compare_exchange_weak(pos, pos + 1,
+                                            std::memory_order_relaxed))
+          break;
+      } else if (dif < 0) {
+        return false;
+      } else {
+        pos = m_dequeue.load(std::memory_order_relaxed);
+      }
+    }
+    out = std::move(cell->data);
+    cell->data = T{};
+    cell->seq.store(pos + m_mask + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Yaklaşık: yalnızca park kararında, ardından yeniden denenir
+  bool empty() const { return m_dequeue.load() >= m_enqueue.load(); }
+
+private:
+  struct Cell {
+    std::atomic<size_t> seq{0};
+    T data{};
+  };
+
+  std::unique_ptr<Cell[]> m_cells;
+  size_t m_mask = 0;
+  // Üretici ve tüketici indeksleri ayrı önbellek satırlarında
+  alignas(64) std::atomic<size_t> m_enqueue{0};
+  alignas(64) std::atomic<size_t> m_dequeue{0};
+};
+
+// Sınıf başına bir MpmcRing + boşta bekleyen tüketiciler için park yeri.
+// Kilit yalnızca uyuyan bir tüketiciyi uyandırmak için alınır; halka
+// dolarsa öğe kilitli taşma kuyruğuna düşer.
+class RingQueue {
+public:
+  RingQueue() {
+    for (auto &r : m_rings)
+      r = std::make_unique<MpmcRing<ItemPtr>>(4096);
+  }
+
+  void push(int cls, ItemPtr v) {
+    if (!m_rings[cls]->tryPush(v)) {
+      std::lock_guard<std::mutex> lk(m_overflowMtx);
+      m_overflow[cls].push_back(std::move(v));
+      m_overflowCount.fetch_add(1);
+    }
+    // Öğe görünür olduktan sonra uyuyan sayısı okunur (pop'taki sırayla
+    // eşleşir: ya tüketici öğeyi görür ya da üretici tüketiciyi)
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_sleepers.load() > 0) {
+      std::lock_guard<std::mutex> lk(m_parkMtx);
+      m_parked.notify_one();
+    }
+  }
+
+  bool pop(ItemPtr &out, const std::atomic<bool> &stop) {
+    for (;;) {
+      if (tryPop(out))
+        return true;
+      m_sleepers.fetch_add(1);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      bool got = tryPop(out);
+      if (!got && !stop.load()) {
+        std::unique_lock<std::mutex> lk(m_parkMtx);
+        m_parked.wait(lk, [&] { return !empty() || stop.load(); });
+      }
+      m_sleepers.fetch_sub(1);
+      if (got)
+        return true;
+      if (stop.load())
+        return false;
+    }
+  }
+
+  void wakeAll() {
+    std::lock_guard<std::mutex> lk(m_parkMtx);
+    m_parked.notify_all();
+  }
+
+private:
+  bool tryPop(ItemPtr &out) {
+    for (int c = 0; c < kClasses; ++c) {
+      if (m_rings[c]->tryPop(out))
+        return true;
+      if (m_overflowCount.load() > 0) {
+        std::lock_guard<std::mutex> lk(m_overflowMtx);
+        if (!m_overflow[c].empty()) {
+          out = std::move(m_overflow[c].front());
+          m_overflow[c].pop_front();
+          m_overflowCount.fetch_sub(1);
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  bool empty() const {
+    if (m_overflowCount.load() > 0)
+      return false;
+    for (auto &r : m_rings)
+      if (!r->empty())
+        return false;
+    return true;
+  }
+
+  std::unique_ptr<MpmcRing<ItemPtr>> m_rings[kClasses];
+  std::mutex m_overflowMtx;
+  std::deque<ItemPtr> m_overflow[kClasses];
+  std::atomic<int> m_overflowCount{0};
+
+  alignas(64) std::atomic<int> m_sleepers{0};
+  std::mutex m_parkMtx;
+  std::condition_variable m_parked;
+};
+
+// Üretimdeki kuyruk
+class MutexQueue {
+public:
+  void push(int cls, ItemPtr v) { m_q.push(cls, std::move(v)); }
+  bool pop(ItemPtr &out, const std::atomic<bool> &stop) {
+    return m_q.pop(out, -1, stop);
+  }
+  void wakeAll() { m_q.wakeAll(); }
+
+private:
+  TaskQueue<ItemPtr, kClasses> m_q;
+};
+
+// Öğe başına yapılan sahte iş (stat/hash kontrolü yerine)
+inline void spin(int n) {
+  volatile unsigned x = 0;
+  for (int i = 0; i < n; ++i)
+    x = x * 31 + i;
+}
+
+template <class Queue> double run(int workers, int items) {
+  Queue q;
+  std::atomic<bool> stop{false};
+  std::atomic<int> remaining{items};
+
+  std::vector<std::thread> pool;
+  for (int w = 0; w < workers; ++w) {
+    pool.emplace_back([&] {
+      ItemPtr it;
+      while (q.pop(it, stop)) {
+        spin(200);
+        if (it->hops > 0) {
+          it->hops--;
+          it->cls = std::min(it->cls + 1, kClasses - 1);
+          int cls = it->cls;
+          q.push(cls, std::move(it));
+          continue;
+        }
+        if (remaining.fetch_sub(1) == 1) {
+          stop = true;
+          q.wakeAll();
+        }
+      }
+    });
+  }
+
+  auto t0 = std::chrono::steady_clock::now();
+  for (int i = 0; i < items; ++i) {
+    auto it = std::make_shared<Item>();
+    it->cls = i % kClasses;
+    it->hops = (i % 4 == 0) ? 1 : 0; // ~%25'i ağ aşamasına geçer
+    q.push(i % kClasses, std::move(it));
+  }
+  for (auto &t : pool)
+    t.join();
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0)
+      .count();
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  int items = argc > 1 ? std::atoi(argv[1]) : 400000;
+  std::printf("%-8s %14s %14s %8s\n", "isci", "mutex+deque", "kilitsiz",
+              "hiz");
+  for (int workers : {2, 12, 32}) {
+    double a = run<MutexQueue>(workers, items);
+    double b = run<RingQueue>(workers, items);
+    std::printf("%-8d %11.0f/sn %11.0f/sn %7.2fx\n", workers, items / a,
+                items / b, a / b);
+  }
+  return 0;
+}
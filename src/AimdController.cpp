@@ -0,0 +1,66 @@
+#include "AimdController.h"
+
+#include <algorithm>
+#include <iostream>
+
+AimdController::AimdController(int minLimit, int maxLimit, int initial)
+    : m_min(minLimit), m_max(std::max(minLimit, maxLimit)),
+      m_limit(std::clamp(initial, minLimit, std::max(minLimit, maxLimit))) {}
+
+void AimdController::onResult(bool ok, bool congestion) {
+  if (ok)
+    m_windowOk.fetch_add(1);
+  else if (congestion)
+    m_windowErrors.fetch_add(1);
+}
+
+void AimdController::tick(int inFlight) {
+  int peak = m_peakInFlight.load();
+  while (inFlight > peak &&
+         !m_peakInFlight.compare_exchange_weak(peak, inFlight))
+    ;
+
+  std::unique_lock<std::mutex> lk(m_tickMtx, std::try_to_lock);
+  if (!lk.owns_lock())
+    return;
+  auto now = Clock::now();
+  auto elapsed = now - m_windowStart;
+  if (elapsed < kWindow)
+    return;
+  m_windowStart = now;
+
+  double secs = std::chrono::duration<double>(elapsed).count();
+  double tput = static_cast<double>(m_windowBytes.exchange(0)) / secs;
+  int ok = m_windowOk.exchange(0);
+  int errors = m_windowErrors.exchange(0);
+  int peakInFlight = m_peakInFlight.exchange(0);
+  double errRate = (ok + errors) > 0 ? double(errors) / (ok + errors) : 0.0;
+
+  m_throughput = tput;
+  m_errorRate = errRate;
+
+  int limit = m_limit.load();
+  int next = limit;
+  if (errors > 0 && errRate > 0.02) {
+    // Multiplicative decrease
+    next = std::max(m_min, limit / 2);
+    m_bestThroughput = tput;
+    m_slowStart = false;
+  } else if (peakInFlight >= limit && tput >= m_bestThroughput * 0.95) {
+    // Additive increase: limit doluyken hâlâ kazanç var
+    next = std::min(m_max, m_slowStart ? limit * 2 : limit + 1);
+    m_bestThroughput = std::max(m_bestThroughput, tput);
+  } else {
+    // Koşullar değişebilir; en iyi değer yavaşça unutulur
+    if (peakInFlight >= limit)
+      m_slowStart = false;
+    m_bestThroughput *= 0.9;
+  }
+
+  if (next != limit) {
+    m_limit = next;
+    std::cout << "[AIMD] Eşzamanlılık " << limit << " -> " << next << " ("
+              << static_cast<long long>(tput / 1024) << " KiB/s, hata %"
+              << static_cast<int>(errRate * 100) << ")" << std::endl;
+  }
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
+// Eşzamanlı transfer sayısını ağın durumuna göre ayarlayan AIMD denetleyici.
+// Her pencerede goodput ve hata/zaman aşımı oranı ölçülür:
+//  - tıkanıklık işareti (timeout, 429/5xx, bağlantı hatası) -> limit yarıya
+//  - limit doluyken goodput hâlâ artıyorsa                  -> limit + 1
+//  - goodput yerinde sayıyorsa limit korunur
+// İlk tıkanıklık/plato görülene kadar (TCP slow-start gibi) limit ikiye
+// katlanarak büyür; böylece hızlı hatlarda doğru değere çabuk ulaşılır.
+class AimdController {
+public:
+  AimdController(int minLimit, int maxLimit, int initial);
+
+  void onBytes(long long n) { m_windowBytes.fetch_add(n); }
+  void onResult(bool ok, bool congestion);
+  // Event-loop'lar her turda çağırır; pencere dolduysa limiti günceller
+  void tick(int inFlight);
+
+  int limit() const { return m_limit.load(); }
+  double throughput() const { return m_throughput.load(); } // bayt/sn
+  double errorRate() const { return m_errorRate.load(); }
+
+private:
+  using Clock = std::chrono::steady_clock;
+  static constexpr std::chrono::milliseconds kWindow{500};
+
+  const int m_min;
+  const int m_max;
+  std::atomic<int> m_limit;
+  std::atomic<double> m_throughput{0.0};
+  std::atomic<double> m_errorRate{0.0};
+
+  std::atomic<long long> m_windowBytes{0};
+  std::atomic<int> m_windowOk{0};
+  std::atomic<int> m_windowErrors{0};
+  std::atomic<int> m_peakInFlight{0};
+
+  std::mutex m_tickMtx;
+  Clock::time_point m_windowStart = Clock::now();
+  double m_bestThroughput = 0.0;
+  bool m_slowStart = true;
+};
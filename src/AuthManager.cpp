@@ -1,5 +1,9 @@
 #include "AuthManager.h"
-#include <cpr/cpr.h>
+#include "DurableCommit.h"
+#include "HttpClient.h"
+#include "MirrorTable.h"
+#include "SingleFlight.h"
+
 #include <nlohmann/json.hpp>
 #include <spdlog/spdlog.h>
 
@@ -7,7 +11,6 @@
 #include <QDir>
 #include <QPixmap>
 #include <QUuid>
-#include <fstream>
 #include <iostream>
 #include <thread>
 
@@ -41,13 +44,10 @@ void AuthManager::loginElyBy(const QString &username, const QString &password) {
                    {"clientToken", clientToken},
                    {"requestUser", true}};
 
-      auto r = cpr::Post(cpr::Url{ELYBY_AUTH},
-                         cpr::Header{{"Content-Type", "application/json"},
-                                     {"User-Agent", "MixLauncher/2.0"},
-                                     {"Accept", "application/json"}},
-                         cpr::Body{body.dump()},
-                         cpr::VerifySsl{false} // Linux SSL fix
-      );
+      HttpOptions opt;
+      opt.headers = {{"Content-Type", "application/json"},
+                     {"Accept", "application/json"}};
+      auto r = HttpClient::instance().post(ELYBY_AUTH, body.dump(), opt);
 
       if (r.status_code == 200) {
         auto j = json::parse(r.text);
@@ -90,7 +90,10 @@ void AuthManager::fetchSkin(const QString &username) {
   std::string url =
       "http://skinsystem.ely.by/skins/" + username.toStdString() + ".png";
   std::thread([this, url]() {
-    auto r = cpr::Get(cpr::Url{url}, cpr::VerifySsl{false}, cpr::Timeout{5000});
+    // Skin yalnızca süs: yavaş sunucu arayüzü bekletmesin
+    HttpOptions opt;
+    opt.timeoutMs = 5000;
+    auto r = HttpClient::instance().get(url, opt);
     if (r.status_code == 200 && !r.text.empty()) {
       QPixmap pm;
       if (pm.loadFromData((const uchar *)r.text.data(), r.text.size())) {
@@ -101,34 +104,48 @@ void AuthManager::fetchSkin(const QString &username) {
 }
 
 void AuthManager::ensureAuthlibInjector() {
-  if (fs::exists(m_authlibPath.toStdString()))
+  std::string path = m_authlibPath.toStdString();
+  if (fs::exists(path))
     return;
 
-  std::thread([this]() {
-    spdlog::info("AuthLib-injector meta indiriliyor...");
-    auto r = cpr::Get(cpr::Url{AUTHLIB_URL}, cpr::VerifySsl{false},
-                      cpr::Header{{"User-Agent", "MixLauncher/2.0"}});
-
-    if (r.status_code != 200) {
-      spdlog::error("AuthLib meta hatasi: {}", r.status_code);
-      return;
-    }
+  std::thread([path]() {
+    // Hem AuthManager hem LauncherCore çağırır: aynı jar için ikinci çağrı
+    // uçuştaki indirmeyi bekler, dosyaya iki thread yazmaz
+    static SingleFlight<bool> flights;
+    flights.run(path, [&path] {
+      if (fs::exists(path))
+        return true;
+      spdlog::info("AuthLib-injector meta indiriliyor...");
+      auto r =
+          MirrorTable::instance().fetch(AUTHLIB_URL, [](const std::string &u) {
+            return HttpClient::instance().get(u);
+          });
+
+      if (r.status_code != 200) {
+        spdlog::error("AuthLib meta hatasi: {}", r.status_code);
+        return false;
+      }
 
-    try {
-      auto j = json::parse(r.text);
-      std::string dl = j.value("download_url", "");
-      if (dl.empty())
-        return;
-
-      spdlog::info("AuthLib JAR indiriliyor: {}", dl);
-      auto jar = cpr::Get(cpr::Url{dl}, cpr::VerifySsl{false});
-      if (jar.status_code == 200) {
-        std::ofstream ofs(m_authlibPath.toStdString(), std::ios::binary);
-        ofs.write(jar.text.data(), jar.text.size());
-        spdlog::info("AuthLib-injector hazir.");
+      try {
+        auto j = json::parse(r.text);
+        std::string dl = j.value("download_url", "");
+        if (dl.empty())
+          return false;
+
+        spdlog::info("AuthLib JAR indiriliyor: {}", dl);
+        auto jar =
+            MirrorTable::instance().fetch(dl, [](const std::string &u) {
+              return HttpClient::instance().get(u);
+            });
+        if (jar.status_code == 200 &&
+            DurableCommit::writeFile(path, jar.text)) {
+          spdlog::info("AuthLib-injector hazir.");
+          return true;
+        }
+      } catch (...) {
       }
-    } catch (...) {
-    }
+      return false;
+    });
   }).detach();
 }
 
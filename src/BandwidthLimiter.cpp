@@ -0,0 +1,94 @@
+#include "BandwidthLimiter.h"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <thread>
+
+BandwidthLimiter &BandwidthLimiter::instance() {
+  static BandwidthLimiter inst;
+  return inst;
+}
+
+void BandwidthLimiter::setRate(long long bytesPerSec) {
+  m_rate = std::max(0LL, bytesPerSec);
+  spdlog::info("Hiz siniri: {} KiB/s", m_rate.load() / 1024);
+}
+
+void BandwidthLimiter::setGameRate(long long bytesPerSec) {
+  m_gameRate = std::max(0LL, bytesPerSec);
+}
+
+void BandwidthLimiter::gameStarted() {
+  if (m_gamesRunning.fetch_add(1) == 0)
+    spdlog::info("Oyun acik: indirme hizi {} KiB/s ile sinirlandi",
+                 effectiveRate() / 1024);
+}
+
+void BandwidthLimiter::gameExited() {
+  if (m_gamesRunning.fetch_sub(1) == 1)
+    spdlog::info("Oyun kapandi: indirme hizi siniri kaldirildi");
+}
+
+long long BandwidthLimiter::effectiveRate() const {
+  long long r = m_rate.load();
+  if (m_gamesRunning.load() > 0) {
+    long long g = m_gameRate.load();
+    if (g > 0)
+      r = (r > 0) ? std::min(r, g) : g;
+  }
+  return r;
+}
+
+void BandwidthLimiter::refill(long long rate) {
+  auto now = Clock::now();
+  double secs = std::chrono::duration<double>(now - m_last).count();
+  m_last = now;
+  // Kova kapasitesi: 250 ms'lik trafik (en az 64 KiB) kadar patlama
+  double cap = std::max(rate * 0.25, 65536.0);
+  m_tokens = std::min(cap, m_tokens + secs * static_cast<double>(rate));
+}
+
+bool BandwidthLimiter::acquire(size_t n, const std::atomic<bool> *cancel,
+                               long maxWaitMs) {
+  long long rate = effectiveRate();
+  if (rate <= 0)
+    return true;
+
+  auto deadline = maxWaitMs < 0
+                      ? Clock::time_point::max()
+                      : Clock::now() + std::chrono::milliseconds(maxWaitMs);
+  std::unique_lock<std::mutex> lk(m_mtx);
+  refill(rate);
+  // Önceki çekimin borcu ödenene kadar bekle, sonra borçlan
+  while (m_tokens < 0.0) {
+    auto now = Clock::now();
+    if (now >= deadline)
+      return false;
+    double waitSecs =
+        std::min({-m_tokens / static_cast<double>(rate), 0.05,
+                  std::chrono::duration<double>(deadline - now).count()});
+    lk.unlock();
+    std::this_thread::sleep_for(std::chrono::duration<double>(waitSecs));
+    if (cancel && cancel->load())
+      return false;
+    rate = effectiveRate();
+    lk.lock();
+    if (rate <= 0) {
+      m_tokens = 0.0;
+      return true;
+    }
+    refill(rate);
+  }
+  m_tokens -= static_cast<double>(n);
+  return true;
+}
+
+bool BandwidthLimiter::ready() {
+  long long rate = effectiveRate();
+  if (rate <= 0)
+    return true;
+  std::lock_guard<std::mutex> lk(m_mtx);
+  refill(rate);
+  return m_tokens >= 0.0;
+}
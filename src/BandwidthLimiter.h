@@ -0,0 +1,49 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+
+// Süreç genelinde indirme hızı sınırı (token bucket).
+// DownloadManager event-loop'ları ve ModManager indirmeleri aynı kovadan
+// token çeker; sınır çalışma anında değiştirilebilir. Bir oyun süreci
+// açıkken sınır otomatik olarak düşürülür (ses/oyun trafiği boğulmasın).
+class BandwidthLimiter {
+public:
+  static BandwidthLimiter &instance();
+
+  // bytesPerSec <= 0: sınırsız
+  void setRate(long long bytesPerSec);
+  long long rate() const { return m_rate.load(); }
+
+  // Oyun açıkken uygulanacak tavan (varsayılan 2 MiB/s)
+  void setGameRate(long long bytesPerSec);
+  void gameStarted();
+  void gameExited();
+
+  // O an geçerli sınır (0 = sınırsız)
+  long long effectiveRate() const;
+
+  // n bayt için token al; önceki çekimlerin borcu ödenene kadar bekler.
+  // cancel kurulursa ya da maxWaitMs (<0: sınırsız) dolarsa token almadan
+  // false döner; çağıran sonra yeniden dener.
+  bool acquire(size_t n, const std::atomic<bool> *cancel = nullptr,
+               long maxWaitMs = -1);
+  // Beklemeden token alınabilir mi (borç yok ya da sınır yok)
+  bool ready();
+
+private:
+  BandwidthLimiter() = default;
+  void refill(long long rate);
+
+  using Clock = std::chrono::steady_clock;
+
+  std::atomic<long long> m_rate{0};
+  std::atomic<long long> m_gameRate{2LL * 1024 * 1024};
+  std::atomic<int> m_gamesRunning{0};
+
+  std::mutex m_mtx;
+  double m_tokens = 0.0;
+  Clock::time_point m_last = Clock::now();
+};
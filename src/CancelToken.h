@@ -0,0 +1,20 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+// Uzun süren ağ işleri için paylaşılan iptal bayrağı. Kopyalar aynı
+// bayrağı görür; cancel() herhangi bir thread'den çağrılabilir.
+class CancelToken {
+public:
+  CancelToken() : m_flag(std::make_shared<std::atomic<bool>>(false)) {}
+
+  void cancel() const { m_flag->store(true); }
+  bool cancelled() const { return m_flag->load(); }
+
+  // BandwidthLimiter::acquire gibi ham bayrak bekleyenler için
+  const std::atomic<bool> *flag() const { return m_flag.get(); }
+
+private:
+  std::shared_ptr<std::atomic<bool>> m_flag;
+};
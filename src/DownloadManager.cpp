@@ -1,26 +1,102 @@
 #include "DownloadManager.h"
+#include "BandwidthLimiter.h"
+#include "DurableCommit.h"
+#include "FileSink.h"
+#include "HttpClient.h"
+#include "Metrics.h"
+#include "MirrorTable.h"
+#include "ObjectStore.h"
+#include "UringWriter.h"
 
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <spdlog/spdlog.h>
 
-#include <cpr/cpr.h>
-#include <openssl/evp.h>
+#include <curl/curl.h>
 
+#include <algorithm>
 #include <chrono>
 #include <filesystem>
-#include <fstream>
-#include <iomanip>
 #include <iostream>
+#include <mutex>
 #include <thread>
+#include <utility>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace fs = std::filesystem;
 
-DownloadManager::DownloadManager(int workerCount, QObject *parent)
-    : QObject(parent), m_workerCount(workerCount) {
-  if (m_workerCount < 2)
-    m_workerCount = 2;
-  if (m_workerCount > 32)
-    m_workerCount = 32;
+// Uçuştaki tek bir transfer (bir easy handle + disk sink'i)
+struct DownloadManager::Transfer {
+  DownloadManager *owner = nullptr;
+  UringWriter *writer = nullptr; // Küçük dosyalar için toplu yazıcı (ya da yok)
+  std::shared_ptr<DownloadTask> task;
+  CURL *easy = nullptr;
+  FileSink sink;
+  std::string partPath;      // <dest>.part – başarıda dest'e taşınır
+  long long resumeFrom = 0;  // Önceki denemeden kalan bayt sayısı
+  std::string range;         // CURLOPT_RANGE ("N-")
+  std::string url;           // Seçilen aynadaki tam URL
+  std::string host;          // Devre kesici anahtarı
+  bool rejected = false;     // 200/206 dışı yanıt: gövde diske yazılmaz
+  bool retryable = false;    // Hata geçici mi (yeniden denenebilir)
+  long retryAfter = 0;       // Sunucunun Retry-After değeri (sn)
+
+  // Parçalı indirmede bu transferin aralığı [chunkPos, chunkEnd]
+  std::shared_ptr<ChunkJob> chunk;
+  long long chunkPos = 0;    // Sıradaki baytın dosyadaki ofseti
+  long long chunkEnd = 0;
+  bool started = false;      // İlk gövde baytı geldi mi
+  bool throttled = false;    // Hız sınırı yüzünden duraklatıldı
+};
+
+// Büyük bir dosyanın paralel Range parçaları. Parçaların hepsi aynı
+// event-loop'ta yürür; kilit gerekmez.
+struct DownloadManager::ChunkJob {
+  std::shared_ptr<DownloadTask> task;
+  RangeSink sink;               // <dest>.part, expectedSize kadar ayrılmış
+  std::string url;              // Seçilen ayna
+  int pending = 0;              // Bitmemiş parça sayısı
+  bool failed = false;
+  bool retryable = true;
+  bool rangeUnsupported = false; // Sunucu 206 yerine 200 döndü
+  long retryAfter = 0;
+
+  ~ChunkJob() {
+    if (sink.isOpen()) // İptal: yarım dosya diskte kalmasın
+      sink.discard();
+  }
+};
+
+// Parça sayısı: her parça en az bu kadar
+static constexpr long long kMinChunkBytes = 4LL << 20;
+// Bu boyuta kadar olan gövdeler bellekte toplanıp UringWriter ile yazılır;
+// daha büyükleri planlamada diskte önceden ayrılır
+static constexpr long long kBufferedMaxBytes = 256LL << 10;
+// Boş alan denetiminde indirmelerin üstüne bırakılan pay
+static constexpr long long kSpaceReserveBytes = 64LL << 20;
+// Hız sınırında write callback'in tek seferde en uzun beklemesi; token
+// gelmezse transfer duraklatılır, event-loop iptalleri işlemeye döner
+static constexpr int kBandwidthWaitMs = 20;
+
+DownloadManager::DownloadManager(int maxTransfers, QObject *parent)
+    : QObject(parent), m_maxTransfers(maxTransfers) {
+  if (m_maxTransfers < 2)
+    m_maxTransfers = 2;
+  if (m_maxTransfers > 128)
+    m_maxTransfers = 128;
+
+  // Bir event-loop ~16 transferi rahatça sürer; en fazla 4 thread
+  m_loopCount = std::clamp((m_maxTransfers + 15) / 16, 1, 4);
+  // Temkinli başla, AIMD bağlantının kaldırdığı yere çıkarır
+  m_aimd = std::make_unique<AimdController>(2, m_maxTransfers,
+                                            std::min(8, m_maxTransfers));
+  // Hash'leme CPU'ya bağlı: çekirdek sayısı kadar doğrulayıcı
+  m_verifyCount =
+      std::clamp(static_cast<int>(std::thread::hardware_concurrency()), 2, 16);
+
+  HttpClient::instance(); // curl_global_init, event-loop'lardan önce
+
+  m_commits = std::make_unique<DurableCommit>();
 
   m_pollTimer = std::make_unique<QTimer>(this);
   m_pollTimer->setInterval(150);
@@ -28,169 +104,1019 @@ DownloadManager::DownloadManager(int workerCount, QObject *parent)
           &DownloadManager::pollProgress);
 }
 
-DownloadManager::~DownloadManager() { cancel(); }
+DownloadManager::~DownloadManager() { shutdown(); }
 
-void DownloadManager::enqueue(std::shared_ptr<DownloadTask> task) {
-  std::lock_guard<std::mutex> lk(m_queueMtx);
-  m_queue.push_back(std::move(task));
-  m_totalCount.fetch_add(1);
-  m_queueCv.notify_one();
+std::shared_ptr<DownloadJob> DownloadManager::createJob() {
+  // Son referans bir worker'da düşebilir: QObject kendi thread'inde silinsin
+  auto *job = new DownloadJob(m_nextJobId.fetch_add(1));
+  job->moveToThread(thread());
+  return std::shared_ptr<DownloadJob>(job,
+                                      [](DownloadJob *j) { j->deleteLater(); });
 }
 
-void DownloadManager::enqueueBatch(
+void DownloadManager::submit(
+    const std::shared_ptr<DownloadJob> &job,
     const std::vector<std::shared_ptr<DownloadTask>> &tasks) {
-  std::lock_guard<std::mutex> lk(m_queueMtx);
-  m_totalCount.fetch_add(static_cast<int>(tasks.size()));
-  for (const auto &t : tasks)
-    m_queue.push_back(t);
-  m_queueCv.notify_all();
+  job->m_totalCount.fetch_add(static_cast<int>(tasks.size()));
+  for (const auto &t : tasks) {
+    if (t->priority == DownloadPriority::Critical)
+      job->m_criticalTotal.fetch_add(1);
+    job->m_bytesPlanned.fetch_add(t->expectedSize);
+  }
+  {
+    std::lock_guard<std::mutex> lk(m_jobsMtx);
+    m_jobs.push_back(job);
+  }
+  startWorkers();
+  QMetaObject::invokeMethod(m_pollTimer.get(), "start");
+  if (tasks.empty()) {
+    latch(job);
+    return;
+  }
+
+  int shared = 0;
+  for (const auto &t : tasks) {
+    t->job = job;
+    {
+      // Aynı içerik zaten uçuşta: takipçi ol, sonucu bekle
+      std::lock_guard<std::mutex> lk(m_inflightMtx);
+      auto it = m_inflight.find(t->url);
+      if (it == m_inflight.end()) {
+        m_inflight.emplace(t->url, t);
+      } else if (it->second->expectedSha1 == t->expectedSha1 &&
+                 (!t->expectedSha1.empty() ||
+                  it->second->destPath == t->destPath)) {
+        it->second->followers.push_back(t);
+        ++shared;
+        continue;
+      }
+    }
+    pushTask(m_verifyStage, t);
+  }
+
+  std::cout << "[INFO] Is #" << job->id() << ": " << tasks.size()
+            << " dosya kuyruklandi";
+  if (shared > 0)
+    std::cout << " (" << shared << " tanesi ucustaki indirmeyi paylasiyor)";
+  std::cout << std::endl;
 }
 
-void DownloadManager::start() {
-  if (m_running.load())
-    return;
-  m_running = true;
-  m_cancelled = false;
-  m_completedCount = 0;
-  m_failedCount = 0;
+void DownloadManager::setHashIndexPath(const std::string &path) {
+  m_hashIndex.load(path);
+}
 
-  for (int i = 0; i < m_workerCount; ++i)
-    m_workers.emplace_back(&DownloadManager::workerLoop, this);
+DownloadStats DownloadManager::stats() const {
+  DownloadStats s;
+  s.concurrency = m_aimd->limit();
+  s.inFlight = m_inFlight.load();
+  s.throughputBps = m_aimd->throughput();
+  s.errorRate = m_aimd->errorRate();
+  return s;
+}
 
-  // Qt Timer
-  QMetaObject::invokeMethod(m_pollTimer.get(), "start");
+bool DownloadManager::prepare(
+    const std::vector<std::shared_ptr<DownloadTask>> &tasks,
+    std::string &error) {
+  auto &store = ObjectStore::instance();
+  std::vector<std::string> dirs;
+  std::unordered_set<std::string> seenDirs, seenPaths;
+  std::vector<const DownloadTask *> reserve;
+  long long needed = 0;
+
+  for (const auto &t : tasks) {
+    if (!seenPaths.insert(t->destPath).second)
+      continue;
+    std::string dir = fs::path(t->destPath).parent_path().string();
+    if (seenDirs.insert(dir).second)
+      dirs.push_back(dir);
+    if (t->expectedSize <= 0)
+      continue;
+
+    // Boyutu tutan dosya muhtemelen hazır (doğrulama aşaması karar verir),
+    // depodaki nesne ise yer kaplamadan bağlanır
+    std::error_code ec;
+    auto have = fs::file_size(t->destPath, ec);
+    if (!ec && static_cast<long long>(have) == t->expectedSize)
+      continue;
+    if (!t->expectedSha1.empty() && store.contains(t->expectedSha1))
+      continue;
+    auto part = fs::file_size(t->destPath + ".part", ec);
+    needed += t->expectedSize - (ec ? 0 : static_cast<long long>(part));
+    if (t->expectedSize > kBufferedMaxBytes)
+      reserve.push_back(t.get());
+  }
 
-  std::cout << "[INFO] İndirme Başlatıldı -> Worker Sayısı: " << m_workerCount
+  // 1. Dizin ağacı bir kez (varlıklarda 256 önek)
+  for (const auto &d : dirs) {
+    std::error_code ec;
+    fs::create_directories(d, ec);
+  }
+
+  // 2. Boş alan: hedefler aynı oyun dizininde, tek birim varsayılır
+  if (!dirs.empty() && needed > 0) {
+    std::error_code ec;
+    auto space = fs::space(dirs.front(), ec);
+    if (!ec &&
+        static_cast<long long>(space.available) < needed + kSpaceReserveBytes) {
+      error = "Yetersiz disk alani: " + std::to_string(needed >> 20) +
+              " MB gerekli, " + std::to_string(space.available >> 20) +
+              " MB bos";
+      return false;
+    }
+  }
+
+  // 3. Büyük dosyalar için bitişik blok ayır (parçalanmayı azaltır)
+  for (const DownloadTask *t : reserve) {
+    if (!RangeSink::reserve(t->destPath + ".part", t->expectedSize)) {
+      error = "Disk dolu: " + t->destPath + " icin yer ayrilamadi";
+      return false;
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> lk(m_plannedDirsMtx);
+    for (const auto &d : dirs)
+      if (m_plannedSeen.insert(d).second)
+        m_plannedDirs.push_back(d);
+    m_plannedCount = m_plannedDirs.size();
+  }
+  std::cout << "[PLAN] " << dirs.size() << " dizin, " << (needed >> 20)
+            << " MB indirilecek, " << reserve.size() << " dosya on ayrildi"
             << std::endl;
+  return true;
+}
+
+void DownloadManager::startWorkers() {
+  std::lock_guard<std::mutex> lk(m_workersMtx);
+  if (!m_workers.empty() || m_stopping.load())
+    return;
+
+  for (int i = 0; i < m_verifyCount; ++i)
+    m_workers.emplace_back(&DownloadManager::verifyLoop, this);
+  for (int i = 0; i < m_loopCount; ++i)
+    m_workers.emplace_back(&DownloadManager::eventLoop, this);
+
+  std::cout << "[INFO] İndirme Başlatıldı -> Doğrulayıcı: " << m_verifyCount
+            << ", Event-loop: " << m_loopCount
+            << ", Eşzamanlı Transfer: " << m_aimd->limit() << "/"
+            << m_maxTransfers << std::endl;
 }
 
 void DownloadManager::cancel() {
-  m_cancelled = true;
-  m_queueCv.notify_all();
-  for (auto &w : m_workers)
-    if (w.joinable())
-      w.join();
-  m_workers.clear();
-  m_running = false;
-  QMetaObject::invokeMethod(m_pollTimer.get(), "stop");
+  std::lock_guard<std::mutex> lk(m_jobsMtx);
+  for (auto &job : m_jobs)
+    job->cancel();
   std::cout << "[INFO] İndirmeler Dursuruldu." << std::endl;
 }
 
-void DownloadManager::waitUntilDone() {
-  for (auto &w : m_workers)
-    if (w.joinable())
-      w.join();
-  m_workers.clear();
-  m_running = false;
-  QMetaObject::invokeMethod(m_pollTimer.get(), "stop");
-  pollProgress();
+bool DownloadManager::isRunning() const {
+  std::lock_guard<std::mutex> lk(m_jobsMtx);
+  return !m_jobs.empty();
 }
 
-void DownloadManager::workerLoop() {
-  while (true) {
-    std::shared_ptr<DownloadTask> task;
-    {
-      std::unique_lock<std::mutex> lk(m_queueMtx);
-      m_queueCv.wait(lk,
-                     [&] { return !m_queue.empty() || m_cancelled.load(); });
-      if (m_cancelled.load())
-        return;
-      if (m_queue.empty())
-        return;
-      task = m_queue.front();
-      m_queue.pop_front();
-    }
-
-    // SHA-1 Check (Delta Update)
+void DownloadManager::shutdown() {
+  m_stopping = true;
+  wakeAll();
+  {
+    std::lock_guard<std::mutex> lk(m_workersMtx);
+    for (auto &w : m_workers)
+      if (w.joinable())
+        w.join();
+    m_workers.clear();
+  }
+  {
+    std::lock_guard<std::mutex> lk(m_delayedMtx);
+    m_delayed = {};
+  }
+  m_hashIndex.save();
+}
+
+void DownloadManager::pushTask(Stage &stage,
+                               std::shared_ptr<DownloadTask> task) {
+  int cls = static_cast<int>(task->priority);
+  stage.push(cls, std::move(task));
+}
+
+std::shared_ptr<DownloadTask> DownloadManager::popTask(Stage &stage,
+                                                       int waitMs) {
+  std::shared_ptr<DownloadTask> task;
+  while (stage.pop(task, waitMs, m_stopping) && !m_stopping.load()) {
+    if (!abandoned(*task))
+      return task;
+    // İptal edilmiş işin görevi: kimse beklemiyor, sessizce düşür. Önceki
+    // denemelerden ya da plandan kalan .part de silinir.
+    release(*task);
+    std::error_code ec;
+    fs::remove(task->destPath + ".part", ec);
+    task.reset();
+    waitMs = 0;
+  }
+  return nullptr;
+}
+
+void DownloadManager::scheduleRetry(std::shared_ptr<DownloadTask> task,
+                                    RetryPolicy::Clock::time_point due) {
+  std::lock_guard<std::mutex> lk(m_delayedMtx);
+  m_delayed.push({due, std::move(task)});
+}
+
+void DownloadManager::promoteDueRetries() {
+  auto now = RetryPolicy::Clock::now();
+  std::lock_guard<std::mutex> lk(m_delayedMtx);
+  while (!m_delayed.empty() && m_delayed.top().due <= now) {
+    pushTask(m_netStage, m_delayed.top().task);
+    m_delayed.pop();
+  }
+}
+
+void DownloadManager::markDone(const DownloadTask &task, bool ok) {
+  Metrics::instance().add("download_files_total", 1,
+                          ok ? "result=\"ok\"" : "result=\"failed\"");
+  auto followers = release(task);
+  credit(task, ok);
+
+  for (const auto &f : followers) {
+    bool fok = ok;
+    if (ok && f->destPath != task.destPath) {
+      // Aynı içerik başka bir hedefe: depodan bağla ya da kopyala
+      std::error_code ec;
+      if (f->expectedSha1.empty() ||
+          !ObjectStore::instance().materialize(f->expectedSha1, f->destPath)) {
+        fs::create_directories(fs::path(f->destPath).parent_path(), ec);
+        fs::copy_file(task.destPath, f->destPath,
+                      fs::copy_options::overwrite_existing, ec);
+        fok = !ec;
+      }
+      if (fok && !f->expectedSha1.empty())
+        m_hashIndex.record(f->destPath, f->expectedSha1);
+    }
+    if (fok)
+      f->job->m_bytesSkipped.fetch_add(f->expectedSize);
+    credit(*f, fok);
+  }
+}
+
+void DownloadManager::credit(const DownloadTask &task, bool ok) {
+  DownloadJob &job = *task.job;
+  if (task.priority == DownloadPriority::Critical) {
+    if (!ok)
+      job.m_criticalFailed.fetch_add(1);
+    job.m_criticalDone.fetch_add(1);
+  }
+  int finished = ok ? job.m_completedCount.fetch_add(1) + 1 +
+                           job.m_failedCount.load()
+                     : job.m_failedCount.fetch_add(1) + 1 +
+                           job.m_completedCount.load();
+  if (finished >= job.m_totalCount.load())
+    latch(task.job);
+}
+
+void DownloadManager::latch(const std::shared_ptr<DownloadJob> &job) {
+  if (job->m_finished.exchange(true))
+    return;
+  m_indexDirty = true;
+  QMetaObject::invokeMethod(
+      this, [this, job]() { retireJob(job); }, Qt::QueuedConnection);
+}
+
+std::vector<std::shared_ptr<DownloadTask>>
+DownloadManager::release(const DownloadTask &task) {
+  std::vector<std::shared_ptr<DownloadTask>> followers;
+  std::lock_guard<std::mutex> lk(m_inflightMtx);
+  auto it = m_inflight.find(task.url);
+  if (it != m_inflight.end() && it->second.get() == &task) {
+    followers.swap(it->second->followers);
+    m_inflight.erase(it);
+  }
+  return followers;
+}
+
+bool DownloadManager::abandoned(const DownloadTask &task) {
+  if (!task.job->isCancelled())
+    return false;
+  std::lock_guard<std::mutex> lk(m_inflightMtx);
+  return std::all_of(task.followers.begin(), task.followers.end(),
+                     [](const std::shared_ptr<DownloadTask> &f) {
+                       return f->job->isCancelled();
+                     });
+}
+
+void DownloadManager::wakeAll() {
+  m_verifyStage.wakeAll();
+  m_netStage.wakeAll();
+}
+
+// ══════════════════════════════════════════════════════════
+//  Aşama 1: mevcut dosyaları sınıflandır (var / eksik)
+// ══════════════════════════════════════════════════════════
+void DownloadManager::verifyLoop() {
+  while (auto task = popTask(m_verifyStage, -1)) {
+    // SHA-1 Check (Delta Update) – önce stat ile hash dizinine bak
     if (!task->expectedSha1.empty() && fs::exists(task->destPath)) {
+      if (!m_deepVerify.load() &&
+          m_hashIndex.matches(task->destPath, task->expectedSha1)) {
+        task->job->m_bytesSkipped.fetch_add(task->expectedSize);
+        Metrics::instance().add("download_cache_hits_total", 1,
+                                "source=\"index\"");
+        markDone(*task, true);
+        continue;
+      }
       if (verifySha1(task->destPath, task->expectedSha1)) {
-        m_completedCount.fetch_add(1);
+        // adopt dosyayı depodakine yeniden bağlayabilir (yeni inode/mtime):
+        // dizine son hâliyle yazılır
+        ObjectStore::instance().adopt(task->destPath, task->expectedSha1);
+        m_hashIndex.record(task->destPath, task->expectedSha1);
+        task->job->m_bytesSkipped.fetch_add(task->expectedSize);
+        Metrics::instance().add("download_cache_hits_total", 1,
+                                "source=\"sha1\"");
+        markDone(*task, true);
         std::cout << "[SKIP] Hash OK -> " << task->url << std::endl;
         continue;
       }
+      m_hashIndex.forget(task->destPath);
     }
+    // Başka bir profil/sürüm aynı içeriği zaten indirmiş olabilir
+    if (!task->expectedSha1.empty() &&
+        ObjectStore::instance().contains(task->expectedSha1) &&
+        ObjectStore::instance().materialize(task->expectedSha1,
+                                            task->destPath)) {
+      m_hashIndex.record(task->destPath, task->expectedSha1);
+      task->job->m_bytesSkipped.fetch_add(task->expectedSize);
+      std::error_code ec;
+      fs::remove(task->destPath + ".part", ec); // Eski yarım indirme
+      Metrics::instance().add("download_cache_hits_total", 1,
+                              "source=\"store\"");
+      markDone(*task, true);
+      std::cout << "[DEPO] " << task->expectedSha1 << " -> " << task->destPath
+                << std::endl;
+      continue;
+    }
+    // İş başlamadan önce kalmış .part'ın baytları kaldığı yerden devam
+    // edilecek: atlanmış olarak yalnızca burada, bir kez sayılır (aynaya
+    // geçiş ya da yeniden deneme sonrası devamlar bu işte inmiş baytlardır)
+    std::error_code ec;
+    auto part = static_cast<long long>(
+        fs::file_size(task->destPath + ".part", ec));
+    if (!ec && part > 0 &&
+        (task->expectedSize == 0 || part < task->expectedSize)) {
+      task->skippedPart = part;
+      task->job->m_bytesSkipped.fetch_add(part);
+    }
+    pushTask(m_netStage, std::move(task));
+  }
+}
 
-    {
-      std::lock_guard<std::mutex> lk(m_currentFileMtx);
-      m_currentFile = fs::path(task->destPath).filename().string();
+// ══════════════════════════════════════════════════════════
+//  Aşama 2: eksik dosyaları indir (libcurl multi event-loop)
+// ══════════════════════════════════════════════════════════
+void DownloadManager::eventLoop() {
+  CURLM *multi = curl_multi_init();
+  // Aynı host'a giden transferler tek bağlantıda çoğullansın (HTTP/2),
+  // olmazsa keep-alive bağlantılar havuzdan yeniden kullanılsın
+  curl_multi_setopt(multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+  curl_multi_setopt(multi, CURLMOPT_MAX_HOST_CONNECTIONS, 8L);
+  curl_multi_setopt(multi, CURLMOPT_MAXCONNECTS, 32L);
+
+  std::vector<CURL *> idle; // Yeniden kullanılabilir easy handle'lar
+  std::unordered_map<CURL *, std::unique_ptr<Transfer>> active;
+  std::unique_ptr<UringWriter> writer;
+  if (m_useUring.load())
+    writer = UringWriter::create();
+  size_t knownDirs = 0; // writer'a bildirilmiş plan dizini sayısı
+
+  auto acquire = [&idle]() {
+    if (idle.empty())
+      return curl_easy_init();
+    CURL *easy = idle.back();
+    idle.pop_back();
+    curl_easy_reset(easy);
+    return easy;
+  };
+  auto launch = [&](std::unique_ptr<Transfer> t) {
+    t->writer = writer.get();
+    setupEasy(*t);
+    curl_multi_add_handle(multi, t->easy);
+    CURL *easy = t->easy;
+    active.emplace(easy, std::move(t));
+    m_inFlight.fetch_add(1);
+  };
+  auto anyThrottled = [&active]() {
+    return std::any_of(active.begin(), active.end(), [](const auto &entry) {
+      return entry.second->throttled;
+    });
+  };
+  // İşi iptal edilmiş transferleri kes, yarım dosyalarını sil
+  auto abortAbandoned = [&]() {
+    int aborted = 0;
+    for (auto it = active.begin(); it != active.end();) {
+      Transfer &t = *it->second;
+      if (!abandoned(*t.task)) {
+        ++it;
+        continue;
+      }
+      curl_multi_remove_handle(multi, it->first);
+      idle.push_back(it->first);
+      // Parçalı işin .part'ını son parçayla birlikte ChunkJob siler
+      if (!t.chunk) {
+        t.sink.discard();
+        std::error_code ec;
+        fs::remove(t.partPath, ec);
+      }
+      const DownloadTask *self = t.task.get();
+      t.task->job->m_currentTask.compare_exchange_strong(self, nullptr);
+      // Sonuç yok: half-open denemesiyse host kilitli kalmasın
+      m_retry.onAbandoned(t.host);
+      release(*t.task);
+      it = active.erase(it);
+      m_inFlight.fetch_sub(1);
+      ++aborted;
     }
+    if (aborted > 0)
+      std::cout << "[IPTAL] " << aborted << " transfer kesildi" << std::endl;
+  };
 
-    if (downloadOne(*task)) {
-      m_completedCount.fetch_add(1);
-    } else {
-      m_failedCount.fetch_add(1);
+  while (!m_stopping.load()) {
+    promoteDueRetries();
+
+    // Yeni planların oluşturduğu dizinler için mkdirat gönderilmesin
+    if (writer && m_plannedCount.load() > knownDirs) {
+      std::lock_guard<std::mutex> lk(m_plannedDirsMtx);
+      writer->assumeDirs(std::vector<std::string>(
+          m_plannedDirs.begin() + knownDirs, m_plannedDirs.end()));
+      knownDirs = m_plannedDirs.size();
     }
 
-    // Check completion
-    {
-      std::lock_guard<std::mutex> lk(m_queueMtx);
-      if (m_queue.empty())
-        m_queueCv.notify_all();
+    // AIMD limiti event-loop'lar arasında paylaştırılır
+    int maxInFlight = (m_aimd->limit() + m_loopCount - 1) / m_loopCount;
+
+    // 1. Boş slotları kuyruktan doldur
+    while (static_cast<int>(active.size()) < maxInFlight) {
+      // Boşta: bekleyen yeniden denemeler için en fazla 100 ms uyu
+      auto task = popTask(m_netStage, active.empty() ? 100 : 0);
+      if (!task)
+        break;
+
+      // Ayna + devre kesici: kapalı host'ları atla, hepsi kapalıysa ertele
+      std::string url, host;
+      RetryPolicy::Clock::time_point retryAt;
+      auto verdict = chooseEndpoint(*task, url, host, retryAt);
+      if (verdict == RetryPolicy::Verdict::Defer) {
+        scheduleRetry(std::move(task), retryAt);
+        continue;
+      }
+      if (verdict == RetryPolicy::Verdict::Fail) {
+        markDone(*task, false);
+        continue;
+      }
+
+      // UI'da gösterilen dosya, bitene kadar değişmez (büyük jar'ın
+      // ilerlemesi küçük varlıkların altında kaybolmasın)
+      const DownloadTask *none = nullptr;
+      DownloadJob &owner = *task->job;
+      if (owner.m_currentTask.compare_exchange_strong(none, task.get())) {
+        std::lock_guard<std::mutex> lk(owner.m_currentFileMtx);
+        owner.m_currentFile = fs::path(task->destPath).filename().string();
+        owner.m_currentFileSize = task->expectedSize;
+        owner.m_currentFileBytes = 0;
+      }
+
+      // Log
+      std::cout << "[INDIR] " << url << " -> " << task->destPath << std::endl;
+
+      std::string partPath = task->destPath + ".part";
+      std::error_code ec;
+      auto partSize = static_cast<long long>(fs::file_size(partPath, ec));
+      bool resumable = !ec && partSize > 0 &&
+                       (task->expectedSize == 0 ||
+                        partSize < task->expectedSize);
+
+      // Büyük dosya: önceden ayrılmış .part'a paralel aralıklar. Yarım
+      // kalmış tek akışlı .part varsa kaldığı yerden devam etmek daha ucuz.
+      auto job = !resumable && wantsChunks(*task)
+                     ? std::make_shared<ChunkJob>()
+                     : nullptr;
+      if (job && job->sink.open(partPath, task->expectedSize)) {
+        job->task = task;
+        job->url = url;
+        long long size = task->expectedSize;
+        int segments = static_cast<int>(std::clamp<long long>(
+            size / kMinChunkBytes, 2, m_chunkSegments.load()));
+        long long step = (size + segments - 1) / segments;
+        for (long long pos = 0; pos < size; pos += step) {
+          auto t = std::make_unique<Transfer>();
+          t->owner = this;
+          t->task = task;
+          t->easy = acquire();
+          t->partPath = partPath;
+          t->url = url;
+          t->host = host;
+          t->chunk = job;
+          t->chunkPos = pos;
+          t->chunkEnd = std::min(size, pos + step) - 1;
+          t->range = std::to_string(pos) + "-" + std::to_string(t->chunkEnd);
+          job->pending++;
+          launch(std::move(t));
+        }
+        std::cout << "[PARCA] " << job->pending << " parca -> " << url
+                  << std::endl;
+        continue;
+      }
+
+      auto t = std::make_unique<Transfer>();
+      t->owner = this;
+      t->task = task;
+      t->easy = acquire();
+      t->partPath = partPath;
+      t->url = url;
+      t->host = host;
+
+      // Yarım kalmış .part varsa kaldığı yerden devam et
+      if (resumable) {
+        t->resumeFrom = partSize;
+        t->range = std::to_string(partSize) + "-";
+        std::cout << "[DEVAM] " << partSize << " bayttan -> " << url
+                  << std::endl;
+      }
+      launch(std::move(t));
+    }
+
+    // Bellekteki küçük dosyaları diske, doğrulanmışları toplu fsync ile
+    // yerine taşı
+    if (writer && writer->due(active.empty()))
+      writer->flush();
+    if (m_commits->due(active.empty()))
+      m_commits->flush();
+    // Biten işlerin hash dizini UI thread'i yerine burada yazılır
+    if (active.empty() && m_indexDirty.exchange(false))
+      m_hashIndex.save();
+
+    // İptal edilen işlerin transferleri en geç bir turda (~100 ms) kesilir
+    abortAbandoned();
+
+    if (active.empty())
+      continue;
+
+    // Hız sınırıyla duraklatılanlar kovada token birikince sürdürülür;
+    // devam çağrısı write callback'i hemen yeniden tetikleyebilir
+    if (anyThrottled() && BandwidthLimiter::instance().ready()) {
+      for (auto &entry : active) {
+        if (!entry.second->throttled)
+          continue;
+        entry.second->throttled = false;
+        curl_easy_pause(entry.first, CURLPAUSE_CONT);
+      }
+    }
+
+    // 2. Transferleri ilerlet
+    int running = 0;
+    curl_multi_perform(multi, &running);
+
+    // 3. Biten transferleri topla
+    int pending = 0;
+    while (CURLMsg *msg = curl_multi_info_read(multi, &pending)) {
+      if (msg->msg != CURLMSG_DONE)
+        continue;
+      CURL *easy = msg->easy_handle;
+      CURLcode rc = msg->data.result;
+      curl_multi_remove_handle(multi, easy);
+
+      auto it = active.find(easy);
+      if (it != active.end()) {
+        onTransferDone(*it->second, rc);
+        active.erase(it);
+        m_inFlight.fetch_sub(1);
+      }
+      idle.push_back(easy);
     }
+
+    m_aimd->tick(m_inFlight.load());
+
+    // Duraklatılmış transfer varsa token'lar kısa aralıkla yoklanır
+    if (running > 0)
+      curl_multi_poll(multi, nullptr, 0, anyThrottled() ? kBandwidthWaitMs : 100,
+                      nullptr);
+  }
+
+  writer.reset(); // Yıkıcı bekleyenleri yazar
+  m_commits->flush(); // İptal: doğrulanmış dosyalar kaybolmasın
+  m_inFlight.fetch_sub(static_cast<int>(active.size()));
+  for (auto &entry : active) {
+    m_retry.onAbandoned(entry.second->host);
+    curl_multi_remove_handle(multi, entry.first);
+    curl_easy_cleanup(entry.first);
   }
+  for (CURL *easy : idle)
+    curl_easy_cleanup(easy);
+  curl_multi_cleanup(multi);
 }
 
-bool DownloadManager::downloadOne(const DownloadTask &task) {
-  try {
-    fs::create_directories(fs::path(task.destPath).parent_path());
+void DownloadManager::setupEasy(Transfer &t) {
+  CURL *easy = t.easy;
+  if (!t.range.empty())
+    curl_easy_setopt(easy, CURLOPT_RANGE, t.range.c_str());
+  curl_easy_setopt(easy, CURLOPT_URL, t.url.c_str());
+  // UA, zaman aşımları, TLS ve paylaşılan DNS/TLS oturum önbelleği
+  HttpClient::instance().configure(easy);
+  curl_easy_setopt(easy, CURLOPT_PIPEWAIT, 1L);
+  curl_easy_setopt(easy, CURLOPT_BUFFERSIZE, 64L * 1024);
+  curl_easy_setopt(easy, CURLOPT_WRITEFUNCTION,
+                   &DownloadManager::writeCallback);
+  curl_easy_setopt(easy, CURLOPT_WRITEDATA, &t);
+}
 
-    // Log
-    std::cout << "[INDIR] " << task.url << " -> " << task.destPath << std::endl;
+bool DownloadManager::wantsChunks(const DownloadTask &task) const {
+  long long threshold = m_chunkThreshold.load();
+  return threshold > 0 && !task.noChunk && task.expectedSize >= threshold &&
+         task.expectedSize >= 2;
+}
 
-    cpr::Response r =
-        cpr::Get(cpr::Url{task.url}, cpr::Timeout{30000},
-                 cpr::Header{{"User-Agent", "MixLauncher/2.0 (Linux)"}},
-                 cpr::VerifySsl{false} // Linux SSL fix
-        );
+// Başarısız olunmamış ilk sağlıklı aday seçilir
+static bool alreadyFailed(const DownloadTask &task, const std::string &url) {
+  return std::find(task.failedMirrors.begin(), task.failedMirrors.end(),
+                   url) != task.failedMirrors.end();
+}
 
-    if (r.status_code != 200) {
-      std::cerr << "[HATA] HTTP " << r.status_code << " -> " << task.url
-                << std::endl;
-      return false;
+RetryPolicy::Verdict
+DownloadManager::chooseEndpoint(const DownloadTask &task, std::string &url,
+                                std::string &host,
+                                RetryPolicy::Clock::time_point &retryAt) {
+  bool deferred = false;
+  retryAt = RetryPolicy::Clock::time_point::max();
+  for (const auto &cand : MirrorTable::instance().candidates(task.url)) {
+    if (alreadyFailed(task, cand))
+      continue;
+    std::string h = RetryPolicy::hostOf(cand);
+    RetryPolicy::Clock::time_point at;
+    auto v = m_retry.check(h, at);
+    if (v == RetryPolicy::Verdict::Allow) {
+      url = cand;
+      host = h;
+      return v;
     }
+    if (v == RetryPolicy::Verdict::Defer) {
+      deferred = true;
+      retryAt = std::min(retryAt, at);
+    }
+  }
+  return deferred ? RetryPolicy::Verdict::Defer : RetryPolicy::Verdict::Fail;
+}
 
-    // Write Buffer to File
-    std::ofstream ofs(task.destPath, std::ios::binary);
-    if (!ofs)
-      return false;
-    ofs.write(r.text.data(), static_cast<std::streamsize>(r.text.size()));
-    ofs.close();
+// libcurl'in kümülatif zaman damgalarından aşama süreleri (ms).
+// Yeniden kullanılan bağlantıda DNS/connect/TLS 0 çıkar.
+static Metrics::Timing transferTiming(CURL *easy) {
+  curl_off_t dns = 0, conn = 0, tls = 0, ttfb = 0, total = 0;
+  curl_easy_getinfo(easy, CURLINFO_NAMELOOKUP_TIME_T, &dns);
+  curl_easy_getinfo(easy, CURLINFO_CONNECT_TIME_T, &conn);
+  curl_easy_getinfo(easy, CURLINFO_APPCONNECT_TIME_T, &tls);
+  curl_easy_getinfo(easy, CURLINFO_STARTTRANSFER_TIME_T, &ttfb);
+  curl_easy_getinfo(easy, CURLINFO_TOTAL_TIME_T, &total);
+  curl_off_t ready = std::max(conn, tls); // İstek gönderilebilir an
+  Metrics::Timing t;
+  t.dnsMs = dns / 1000.0;
+  t.connectMs = std::max<curl_off_t>(0, conn - dns) / 1000.0;
+  t.tlsMs = tls > 0 ? std::max<curl_off_t>(0, tls - conn) / 1000.0 : 0.0;
+  t.ttfbMs = std::max<curl_off_t>(0, ttfb - ready) / 1000.0;
+  t.totalMs = total / 1000.0;
+  return t;
+}
 
-    // Verify SHA-1
-    if (!task.expectedSha1.empty()) {
-      if (!verifySha1(task.destPath, task.expectedSha1)) {
-        std::cerr << "[HASH HATA] " << task.destPath << " -> Hash Tutmadi!"
-                  << std::endl;
-        fs::remove(task.destPath);
-        return false;
+void DownloadManager::onTransferDone(Transfer &t, int curlCode) {
+  if (t.chunk) {
+    onChunkDone(t, curlCode);
+    return;
+  }
+  auto &task = t.task;
+  bool ok = finishTransfer(t, curlCode);
+  const DownloadTask *self = task.get();
+  task->job->m_currentTask.compare_exchange_strong(self, nullptr);
+
+  curl_off_t got = 0;
+  curl_easy_getinfo(t.easy, CURLINFO_SIZE_DOWNLOAD_T, &got);
+  Metrics::instance().observeTransfer(t.host, transferTiming(t.easy),
+                                      static_cast<long long>(got), ok);
+  if (ok) {
+    // markDone, dosya toplu fsync ile yerine taşındığında (commitDone)
+    MirrorTable::instance().reportSuccess(t.url);
+    return;
+  }
+  handleFailure(task, t.url, t.retryable, t.retryAfter);
+}
+
+void DownloadManager::handleFailure(const std::shared_ptr<DownloadTask> &task,
+                                    const std::string &url, bool retryable,
+                                    long retryAfter) {
+  // Önce sıradaki aynaya geç (bekleme yok, deneme hakkı harcanmaz)
+  MirrorTable::instance().reportFailure(url);
+  task->failedMirrors.push_back(url);
+  auto cands = MirrorTable::instance().candidates(task->url);
+  if (task->failedMirrors.size() < cands.size()) {
+    Metrics::instance().add("download_mirror_failovers_total");
+    std::cerr << "[AYNA] Sonraki adaya geciliyor -> " << task->url
+              << std::endl;
+    pushTask(m_netStage, task);
+    return;
+  }
+
+  if (retryable && task->retries < m_maxRetries.load()) {
+    auto delay = m_retry.backoff(task->retries, retryAfter);
+    task->retries++;
+    Metrics::instance().add("download_retries_total");
+    task->failedMirrors.clear(); // Yeniden sıralanmış adaylarla baştan
+    std::cerr << "[TEKRAR] " << task->retries << ". deneme " << delay.count()
+              << " ms sonra -> " << task->url << std::endl;
+    scheduleRetry(task, RetryPolicy::Clock::now() + delay);
+  } else {
+    markDone(*task, false);
+  }
+}
+
+void DownloadManager::onChunkDone(Transfer &t, int curlCode) {
+  ChunkJob &job = *t.chunk;
+  long status = 0;
+  curl_easy_getinfo(t.easy, CURLINFO_RESPONSE_CODE, &status);
+  bool ok = curlCode == CURLE_OK && status == 206 && t.chunkPos > t.chunkEnd;
+
+  curl_off_t got = 0;
+  curl_easy_getinfo(t.easy, CURLINFO_SIZE_DOWNLOAD_T, &got);
+  Metrics::instance().observeTransfer(t.host, transferTiming(t.easy),
+                                      static_cast<long long>(got), ok);
+  if (ok) {
+    m_aimd->onResult(true, false);
+    m_retry.onSuccess(t.host);
+  } else if (!job.failed && !job.rangeUnsupported) {
+    // İlk başarısız parça; kardeşleri writeCallback'te kesilir ve hata
+    // sayılmaz
+    job.failed = true;
+    if (curlCode != CURLE_OK) {
+      job.retryable = curlCode != CURLE_WRITE_ERROR;
+      m_aimd->onResult(false, job.retryable);
+      if (job.retryable && !t.started)
+        m_retry.onFailure(t.host);
+      else
+        m_retry.onSuccess(t.host);
+      std::cerr << "[HATA] "
+                << curl_easy_strerror(static_cast<CURLcode>(curlCode))
+                << " (parca " << t.range << ") -> " << t.url << std::endl;
+    } else if (status == 206) {
+      // Eksik gövde: bağlantı erken kapandı
+      job.retryable = true;
+      m_aimd->onResult(false, true);
+      std::cerr << "[HATA] Eksik parca " << t.range << " -> " << t.url
+                << std::endl;
+    } else {
+      std::cerr << "[HATA] HTTP " << status << " (parca " << t.range
+                << ") -> " << t.url << std::endl;
+      bool transient = status == 408 || status == 429 || status >= 500;
+      m_aimd->onResult(false, transient);
+      job.retryable = transient;
+      if (transient) {
+        curl_off_t retryAfter = 0;
+        curl_easy_getinfo(t.easy, CURLINFO_RETRY_AFTER, &retryAfter);
+        job.retryAfter = static_cast<long>(retryAfter);
+        m_retry.onFailure(t.host);
+      } else {
+        m_retry.onSuccess(t.host);
       }
     }
+  } else {
+    // Kardeşi başarısız ya da Range yok sayıldı: bu parçanın sonucu yok
+    m_retry.onAbandoned(t.host);
+  }
+
+  if (--job.pending > 0)
+    return;
+  finishChunkJob(job);
+}
+
+void DownloadManager::finishChunkJob(ChunkJob &job) {
+  auto task = job.task;
+  const DownloadTask *self = task.get();
+  task->job->m_currentTask.compare_exchange_strong(self, nullptr);
+
+  if (job.rangeUnsupported) {
+    job.sink.discard();
+    task->noChunk = true;
+    std::cerr << "[PARCA] Sunucu Range desteklemiyor, tek akisa donuluyor -> "
+              << job.url << std::endl;
+    pushTask(m_netStage, task);
+    return;
+  }
+
+  if (!job.failed) {
+    if (!job.sink.close()) {
+      job.retryable = false;
+    } else if (!task->expectedSha1.empty() &&
+               computeSha1(job.sink.path()) != task->expectedSha1) {
+      // Parçalar birleştikten sonra tek geçişte doğrulanır
+      std::cerr << "[HASH HATA] " << task->destPath << " -> Hash Tutmadi!"
+                << std::endl;
+      job.retryable = true;
+      Metrics::instance().add("download_hash_failures_total");
+    } else {
+      m_commits->add(job.sink.path(), task->destPath,
+                     [this, task](bool ok) { commitDone(*task, ok); });
+      MirrorTable::instance().reportSuccess(job.url);
+      return;
+    }
+  }
+  job.sink.discard();
+  handleFailure(task, job.url, job.retryable, job.retryAfter);
+}
+
+bool DownloadManager::throttle(Transfer &t, size_t len) {
+  // İş iptal edilirse bekleme hemen biter; kalan transfer ya
+  // abortAbandoned'da kesilir ya da (bekleyen başka iş varsa) sürdürülür
+  if (BandwidthLimiter::instance().acquire(len, &t.task->job->m_cancelled,
+                                           kBandwidthWaitMs))
     return true;
-  } catch (const std::exception &e) {
-    std::cerr << "[EXCEPTION] " << e.what() << " -> " << task.url << std::endl;
+  // curl aynı veriyi devam ettirildiğinde yeniden teslim eder
+  t.throttled = true;
+  return false;
+}
+
+size_t DownloadManager::writeCallback(char *ptr, size_t size, size_t nmemb,
+                                      void *userdata) {
+  auto *t = static_cast<Transfer *>(userdata);
+  size_t len = size * nmemb;
+  if (t->rejected)
+    return len;
+
+  if (t->chunk) {
+    ChunkJob &job = *t->chunk;
+    // Kardeş parça başarısız oldu: bu aralığı indirmeye devam etme
+    if (job.failed || job.rangeUnsupported)
+      return 0;
+    if (!t->started) {
+      long status = 0;
+      curl_easy_getinfo(t->easy, CURLINFO_RESPONSE_CODE, &status);
+      if (status == 200) {
+        // Range yok sayıldı: her parça tüm dosyayı indirirdi
+        job.rangeUnsupported = true;
+        return 0;
+      }
+      if (status != 206) {
+        t->rejected = true;
+        return len;
+      }
+      t->started = true;
+    }
+    auto n = static_cast<long long>(len);
+    if (t->chunkPos + n > t->chunkEnd + 1)
+      return 0; // İstenen aralıktan fazlası geldi
+    if (!throttle(*t, len))
+      return CURL_WRITEFUNC_PAUSE;
+    if (!job.sink.writeAt(t->chunkPos, ptr, len))
+      return 0;
+    t->chunkPos += n;
+    t->owner->m_aimd->onBytes(n);
+    DownloadJob &owner = *t->task->job;
+    owner.m_bytesReceived.fetch_add(n);
+    if (owner.m_currentTask.load() == t->task.get())
+      owner.m_currentFileBytes.fetch_add(n);
+    return len;
+  }
+
+  // İlk parça geldiğinde yanıt kodu belli:
+  //  206 -> .part'ın sonuna ekle, 200 -> sunucu Range'i yok saydı, baştan yaz
+  if (!t->sink.isOpen()) {
+    long status = 0;
+    curl_easy_getinfo(t->easy, CURLINFO_RESPONSE_CODE, &status);
+    bool opened = false;
+    bool resumed = status == 206 && t->resumeFrom > 0;
+    if (resumed)
+      opened = t->sink.resume(t->partPath);
+    else if (status == 200 && t->writer && t->task->expectedSize > 0 &&
+             t->task->expectedSize <= kBufferedMaxBytes)
+      opened = t->sink.openBuffered(t->partPath);
+    else if (status == 200)
+      opened = t->sink.open(t->partPath);
+    else {
+      t->rejected = true;
+      return len;
+    }
+    if (!opened)
+      return 0; // CURLE_WRITE_ERROR
+    // Baştan yazılıyor: doğrulamada atlanmış sayılan eski .part baytları
+    // şimdi yeniden inecek
+    DownloadJob &owner = *t->task->job;
+    if (!resumed && t->task->skippedPart > 0)
+      owner.m_bytesSkipped.fetch_sub(std::exchange(t->task->skippedPart, 0));
+    if (owner.m_currentTask.load() == t->task.get())
+      owner.m_currentFileBytes = resumed ? t->resumeFrom : 0;
+  }
+  // Global hız sınırı: token yoksa kısa bekle, gelmezse duraklat
+  if (!throttle(*t, len))
+    return CURL_WRITEFUNC_PAUSE;
+  if (!t->sink.write(ptr, len))
+    return 0;
+  auto n = static_cast<long long>(len);
+  t->owner->m_aimd->onBytes(n);
+  DownloadJob &owner = *t->task->job;
+  owner.m_bytesReceived.fetch_add(n);
+  if (owner.m_currentTask.load() == t->task.get())
+    owner.m_currentFileBytes.fetch_add(n);
+  return len;
+}
+
+bool DownloadManager::finishTransfer(Transfer &t, int curlCode) {
+  const DownloadTask &task = *t.task;
+  if (curlCode != CURLE_OK) {
+    // .part diskte kalır; sonraki deneme Range ile devam eder
+    t.sink.close();
+    t.retryable = curlCode != CURLE_WRITE_ERROR;
+    m_aimd->onResult(false, t.retryable);
+    // Veri gelmeye başladıysa host ayakta; devre yalnızca yanıtsızlıkta açılır
+    if (t.retryable && t.sink.written() == 0)
+      m_retry.onFailure(t.host);
+    else
+      m_retry.onSuccess(t.host);
+    std::cerr << "[HATA] "
+              << curl_easy_strerror(static_cast<CURLcode>(curlCode)) << " ("
+              << t.sink.written() << " bayt alindi) -> " << t.url
+              << std::endl;
+    return false;
+  }
+
+  long status = 0;
+  curl_easy_getinfo(t.easy, CURLINFO_RESPONSE_CODE, &status);
+  if (status != 200 && !(status == 206 && t.resumeFrom > 0)) {
+    std::cerr << "[HATA] HTTP " << status << " -> " << t.url << std::endl;
+    bool transient = status == 408 || status == 429 || status >= 500;
+    m_aimd->onResult(false, transient);
+    if (transient) {
+      curl_off_t retryAfter = 0;
+      curl_easy_getinfo(t.easy, CURLINFO_RETRY_AFTER, &retryAfter);
+      t.retryable = true;
+      t.retryAfter = static_cast<long>(retryAfter);
+      m_retry.onFailure(t.host);
+    } else {
+      m_retry.onSuccess(t.host); // Host ayakta, kaynak yok/yasak
+    }
+    std::error_code ec;
+    if (status == 416) // Geçersiz aralık: .part güvenilmez
+      fs::remove(t.partPath, ec);
+    return false;
+  }
+  m_aimd->onResult(true, false);
+  m_retry.onSuccess(t.host);
+
+  // Boş gövde: dosya hiç açılmadı
+  if (!t.sink.isOpen() && !t.sink.open(t.partPath)) {
+    std::cerr << "[HATA] Dosya acilamadi -> " << t.partPath << std::endl;
+    return false;
+  }
+  if (!t.sink.close()) {
+    t.sink.discard();
+    return false;
+  }
+
+  // Verify SHA-1 (akış sırasında hesaplandı, dosya yeniden okunmaz)
+  if (!task.expectedSha1.empty() && t.sink.sha1Hex() != task.expectedSha1) {
+    std::cerr << "[HASH HATA] " << task.destPath << " -> Hash Tutmadi!"
+              << std::endl;
+    t.sink.discard();
+    t.retryable = true; // Bozuk aktarım olabilir, baştan indir
+    Metrics::instance().add("download_hash_failures_total");
     return false;
   }
+
+  // Küçük dosya: io_uring ile diğerleriyle birlikte yazılır
+  if (t.sink.isBuffered()) {
+    t.writer->add(t.partPath, t.sink.takeBuffer(),
+                  [this, task = t.task, part = t.partPath](bool ok) {
+                    if (!ok) {
+                      commitDone(*task, false);
+                      return;
+                    }
+                    m_commits->add(part, task->destPath,
+                                   [this, task](bool ok) {
+                                     commitDone(*task, ok);
+                                   });
+                  });
+    return true;
+  }
+
+  // Yerine taşıma toplu fsync'ten sonra: dest varsa içeriği tamdır
+  m_commits->add(t.partPath, task.destPath,
+                 [this, task = t.task](bool ok) { commitDone(*task, ok); });
+  return true;
+}
+
+void DownloadManager::commitDone(const DownloadTask &task, bool ok) {
+  if (!ok) {
+    std::cerr << "[HATA] Tasinamadi -> " << task.destPath << std::endl;
+    markDone(task, false);
+    return;
+  }
+  if (!task.expectedSha1.empty()) {
+    ObjectStore::instance().adopt(task.destPath, task.expectedSha1);
+    m_hashIndex.record(task.destPath, task.expectedSha1); // Bağlanmış hâli
+  }
+  markDone(task, true);
 }
 
 std::string DownloadManager::computeSha1(const std::string &filePath) {
-  std::ifstream ifs(filePath, std::ios::binary);
-  if (!ifs)
-    return {};
-  EVP_MD_CTX *ctx = EVP_MD_CTX_new();
-  EVP_DigestInit_ex(ctx, EVP_sha1(), nullptr);
-  char buf[16384];
-  while (ifs.read(buf, sizeof(buf)))
-    EVP_DigestUpdate(ctx, buf, ifs.gcount());
-  if (ifs.gcount() > 0)
-    EVP_DigestUpdate(ctx, buf, ifs.gcount());
-  unsigned char hash[EVP_MAX_MD_SIZE];
-  unsigned int hlen = 0;
-  EVP_DigestFinal_ex(ctx, hash, &hlen);
-  EVP_MD_CTX_free(ctx);
-  std::ostringstream ss;
-  for (unsigned int i = 0; i < hlen; ++i)
-    ss << std::hex << std::setfill('0') << std::setw(2) << (int)hash[i];
-  return ss.str();
+  return ObjectStore::sha1File(filePath);
 }
 
 bool DownloadManager::verifySha1(const std::string &filePath,
@@ -200,34 +1126,95 @@ bool DownloadManager::verifySha1(const std::string &filePath,
   return computeSha1(filePath) == expected;
 }
 
-void DownloadManager::pollProgress() {
-  int done = m_completedCount.load();
-  int fail = m_failedCount.load();
-  int total = m_totalCount.load();
-
-  QString cur;
+DownloadProgress DownloadJob::progress() const {
+  DownloadProgress p;
+  p.filesDone = m_completedCount.load() + m_failedCount.load();
+  p.filesTotal = m_totalCount.load();
+  p.bytesPlanned = m_bytesPlanned.load();
+  p.bytesReceived = m_bytesReceived.load();
+  p.bytesSkipped = m_bytesSkipped.load();
+  p.bytesPerSec = m_rate;
+  long long left = p.bytesPlanned - p.bytesDone();
+  if (left <= 0)
+    p.etaSec = 0.0;
+  else if (m_rate > 0.0)
+    p.etaSec = static_cast<double>(left) / m_rate;
   {
     std::lock_guard<std::mutex> lk(m_currentFileMtx);
-    cur = QString::fromStdString(m_currentFile);
+    p.currentFile = QString::fromStdString(m_currentFile);
+  }
+  p.currentFileBytes = m_currentFileBytes.load();
+  p.currentFileSize = m_currentFileSize.load();
+  return p;
+}
+
+void DownloadManager::pollProgress() {
+  std::vector<std::shared_ptr<DownloadJob>> jobs;
+  {
+    std::lock_guard<std::mutex> lk(m_jobsMtx);
+    jobs = m_jobs;
   }
 
-  emit progressUpdated(done + fail, total, cur);
+  auto now = std::chrono::steady_clock::now();
+  for (const auto &job : jobs) {
+    if (job->isFinished())
+      continue; // retireJob kuyrukta
+    reportProgress(*job, now);
+    // İptal: kuyruktaki görevler sessizce düşer, sayaçlar dolmaz
+    if (job->isCancelled())
+      latch(job);
+  }
+}
+
+void DownloadManager::reportProgress(
+    DownloadJob &job, std::chrono::steady_clock::time_point now) {
+  int done = job.m_completedCount.load();
+  int fail = job.m_failedCount.load();
+  int total = job.m_totalCount.load();
+
+  // Kayan pencere: son 5 sn'deki alınan bayt / geçen süre
+  auto &samples = job.m_rateSamples;
+  samples.emplace_back(now, job.m_bytesReceived.load());
+  while (samples.size() > 2 &&
+         now - samples.front().first > std::chrono::seconds(5))
+    samples.pop_front();
+  double span =
+      std::chrono::duration<double>(now - samples.front().first).count();
+  if (span > 0.0)
+    job.m_rate = (samples.back().second - samples.front().second) / span;
 
-  if (total > 0 && (done + fail) >= total) {
-    if (m_running.load()) {
-      m_running = false;
+  DownloadProgress prog = job.progress();
+  emit job.progressUpdated(done + fail, total, prog.currentFile);
+  emit job.byteProgress(prog);
+
+  int critTotal = job.m_criticalTotal.load();
+  if (!job.m_classpathSignalled && critTotal > 0 &&
+      job.m_criticalDone.load() >= critTotal &&
+      job.m_criticalFailed.load() == 0) {
+    job.m_classpathSignalled = true;
+    emit job.classpathReady();
+    std::cout << "[INFO] Is #" << job.id()
+              << ": classpath hazir, oyun baslatilabilir." << std::endl;
+  }
+}
+
+void DownloadManager::retireJob(const std::shared_ptr<DownloadJob> &job) {
+  reportProgress(*job, std::chrono::steady_clock::now());
+  {
+    std::lock_guard<std::mutex> lk(m_jobsMtx);
+    m_jobs.erase(std::remove(m_jobs.begin(), m_jobs.end(), job),
+                 m_jobs.end());
+    if (m_jobs.empty())
       m_pollTimer->stop();
-      // Wake up workers to exit
-      m_cancelled = true;
-      m_queueCv.notify_all();
-      // Wait for workers
-      for (auto &w : m_workers)
-        if (w.joinable())
-          w.join();
-      m_workers.clear();
-      emit allFinished(done, fail);
-      std::cout << "[INFO] Tüm indirmeler tamamlandı: " << done << " Basarili, "
-                << fail << " Hata." << std::endl;
-    }
   }
+
+  int done = job->m_completedCount.load();
+  int fail = job->m_failedCount.load();
+  bool cancelled = job->isCancelled();
+  if (cancelled) // Düşürülen görevler başarısız sayılır
+    fail = std::max(fail, job->m_totalCount.load() - done);
+  emit job->finished(done, fail);
+  std::cout << "[INFO] Is #" << job->id()
+            << (cancelled ? " iptal edildi: " : " tamamlandi: ") << done
+            << " Basarili, " << fail << " Hata." << std::endl;
 }
@@ -1,73 +1,324 @@
 #pragma once
 
+#include "AimdController.h"
+#include "HashIndex.h"
+#include "RetryPolicy.h"
+#include "TaskQueue.h"
+
+#include <QMetaType>
 #include <QMutex>
 #include <QObject>
 #include <QString>
 #include <QTimer>
+#include <algorithm>
 #include <atomic>
-#include <condition_variable>
+#include <chrono>
 #include <deque>
 #include <functional>
 #include <memory>
+#include <mutex>
+#include <queue>
 #include <string>
 #include <thread>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
+class DurableCommit;
+class DownloadJob;
+
+// Kuyruk öncelik sınıfları (küçük değer önce işlenir)
+enum class DownloadPriority {
+  Critical = 0,   // client jar, kütüphaneler, native'ler (classpath)
+  AssetIndex = 1, // varlık dizini
+  Asset = 2,      // ses/doku nesneleri
+};
+
 // Görev yapısı
 struct DownloadTask {
   std::string url;
   std::string destPath;
   std::string expectedSha1;
   long long expectedSize = 0;
-  int retries = 0;
+  int retries = 0; // Yapılmış yeniden deneme sayısı
+  DownloadPriority priority = DownloadPriority::Critical;
+  // Bu denemede başarısız olan ayna adayları (sıralama arada değişebilir)
+  std::vector<std::string> failedMirrors;
+  // Sunucu Range desteklemiyor: parçalı indirme yerine tek akış
+  bool noChunk = false;
+  // İş başlamadan önce kalmış .part'ın boyu (bytesSkipped'e bir kez eklenir)
+  long long skippedPart = 0;
+  // Görevin ait olduğu iş (DownloadManager::submit atar)
+  std::shared_ptr<DownloadJob> job;
+  // Aynı URL'yi bekleyen diğer görevler (ör. başka bir kurulum); bu görev
+  // bitince sonucu paylaşırlar. Yalnızca DownloadManager kilidi altında.
+  std::vector<std::shared_ptr<DownloadTask>> followers;
 };
 
-class DownloadManager : public QObject {
+// Anlık indirme istatistikleri
+struct DownloadStats {
+  int concurrency = 0;        // AIMD'nin seçtiği eşzamanlı transfer limiti
+  int inFlight = 0;           // Şu an uçuştaki transfer sayısı
+  double throughputBps = 0.0; // Son penceredeki goodput (bayt/sn)
+  double errorRate = 0.0;     // Son penceredeki tıkanıklık hatası oranı
+};
+
+// Bayt düzeyinde ilerleme (UI ve ETA için)
+struct DownloadProgress {
+  int filesDone = 0; // Başarılı + başarısız
+  int filesTotal = 0;
+  long long bytesPlanned = 0;  // Kuyruklanan görevlerin expectedSize toplamı
+  long long bytesReceived = 0; // Ağdan gelen gövde baytları
+  long long bytesSkipped = 0;  // Zaten diskte/depoda olan ya da devam edilen
+  double bytesPerSec = 0.0;    // Kayan pencere (son 5 sn) ortalaması
+  double etaSec = -1.0;        // <0: bilinmiyor
+  QString currentFile;
+  long long currentFileBytes = 0;
+  long long currentFileSize = 0; // 0: bilinmiyor
+
+  long long bytesDone() const { return bytesReceived + bytesSkipped; }
+};
+Q_DECLARE_METATYPE(DownloadProgress)
+
+// Bir kurulumun indirme oturumu. İlerlemesi, tamamlanması ve iptali
+// kendine aittir; thread havuzu, bağlantılar ve AIMD diğer işlerle
+// paylaşılır. DownloadManager::createJob ile oluşturulur; sinyaller main
+// thread'den yayılır. finished, son görevi bitiren worker'ın kurduğu
+// mandaldan kuyruklu çağrıyla gelir; main thread hiçbir worker'ı beklemez.
+class DownloadJob : public QObject {
   Q_OBJECT
 
 public:
-  explicit DownloadManager(int workerCount = 16, QObject *parent = nullptr);
-  ~DownloadManager() override;
+  quint64 id() const { return m_id; }
 
-  void enqueue(std::shared_ptr<DownloadTask> task);
-  void enqueueBatch(const std::vector<std::shared_ptr<DownloadTask>> &tasks);
+  // Kuyruktaki görevler düşürülür, iş bir sonraki poll'da biter.
+  // Aynı URL'yi bekleyen başka bir iş varsa transfer onun için sürer.
+  void cancel() { m_cancelled = true; }
+  bool isCancelled() const { return m_cancelled.load(); }
+  // Tüm görevler sonuçlandı (finished sinyali yolda olabilir)
+  bool isFinished() const { return m_finished.load(); }
 
-  void start();
-  void cancel();
-  void waitUntilDone();
-
-  bool isRunning() const { return m_running.load(); }
+  // Anlık bayt ilerlemesi (hız/ETA son pollProgress'te hesaplanır)
+  DownloadProgress progress() const;
 
 signals:
   void progressUpdated(int done, int total, QString currentFile);
-  void allFinished(int success, int failed);
+  // İşin tüm Critical görevleri başarıyla bitti: oyun başlatılabilir,
+  // varlıklar arka planda inmeye devam eder
+  void classpathReady();
+  // progressUpdated ile aynı periyotta, bayt/hız/ETA bilgisiyle
+  void byteProgress(DownloadProgress progress);
+  void finished(int success, int failed);
 
 private:
-  void workerLoop();
-  bool downloadOne(const DownloadTask &task);
-  std::string computeSha1(const std::string &filePath);
-  bool verifySha1(const std::string &filePath, const std::string &expected);
-  void pollProgress(); // Main thread poll
-
-  // Kuyruk
-  std::deque<std::shared_ptr<DownloadTask>> m_queue;
-  std::mutex m_queueMtx;
-  std::condition_variable m_queueCv;
+  friend class DownloadManager;
+  explicit DownloadJob(quint64 id) : m_id(id) {}
 
-  // Workerlar
-  std::vector<std::thread> m_workers;
-  int m_workerCount;
-  std::atomic<bool> m_running{false};
+  quint64 m_id;
   std::atomic<bool> m_cancelled{false};
+  std::atomic<bool> m_finished{false}; // Mandal: bir kez true olur
 
   // İstatistik
   std::atomic<int> m_totalCount{0};
   std::atomic<int> m_completedCount{0};
   std::atomic<int> m_failedCount{0};
+  std::atomic<int> m_criticalTotal{0};
+  std::atomic<int> m_criticalDone{0};
+  std::atomic<int> m_criticalFailed{0};
+  bool m_classpathSignalled = false; // Yalnızca main thread
+
+  // Bayt sayaçları
+  std::atomic<long long> m_bytesPlanned{0};
+  std::atomic<long long> m_bytesReceived{0};
+  std::atomic<long long> m_bytesSkipped{0};
 
-  // UI için son dosya bilgisi
+  // Kayan pencere hız örnekleri (yalnızca main thread, pollProgress)
+  std::deque<std::pair<std::chrono::steady_clock::time_point, long long>>
+      m_rateSamples;
+  std::atomic<double> m_rate{0.0};
+
+  // UI için son dosya bilgisi. m_currentTask yalnızca kimlik
+  // karşılaştırması için tutulur, hiç dereference edilmez.
   std::string m_currentFile;
-  std::mutex m_currentFileMtx;
+  mutable std::mutex m_currentFileMtx;
+  std::atomic<const DownloadTask *> m_currentTask{nullptr};
+  std::atomic<long long> m_currentFileBytes{0};
+  std::atomic<long long> m_currentFileSize{0};
+};
+
+// Kalıcı, iş (DownloadJob) başına oturum açan iki aşamalı indirme hattı:
+//  1. Doğrulama aşaması (CPU çekirdeği kadar thread) mevcut dosyaları
+//     hash dizini / SHA-1 ile "var" ya da "eksik" diye ayırır.
+//  2. Ağ aşaması yalnızca eksikleri alır: az sayıda event-loop thread'i,
+//     her biri kendi CURLM'i ile çok sayıda transferi aynı anda yürütür;
+//     bağlantılar (keep-alive / HTTP/2) host başına yeniden kullanılır.
+// İki aşama eşzamanlı çalışır. Uçuştaki transfer sayısı AIMD ile ağın
+// durumuna göre genişler/daralır. Thread'ler ilk submit'te başlar ve
+// yöneticiyle birlikte yaşar; aynı anda birden çok iş aynı havuzu kullanır.
+class DownloadManager : public QObject {
+  Q_OBJECT
+
+public:
+  // maxTransfers: AIMD'nin çıkabileceği en yüksek eşzamanlı transfer sayısı
+  explicit DownloadManager(int maxTransfers = 16, QObject *parent = nullptr);
+  ~DownloadManager() override;
+
+  // Boş bir iş. Sinyalleri bağlandıktan sonra submit edilmelidir.
+  std::shared_ptr<DownloadJob> createJob();
+  // Görevleri işe ekleyip kuyruklar (gerekirse havuzu başlatır). Başka bir
+  // işte uçuşta olan aynı URL yeniden indirilmez, sonucu paylaşılır.
+  void submit(const std::shared_ptr<DownloadJob> &job,
+              const std::vector<std::shared_ptr<DownloadTask>> &tasks);
+
+  // Kuyruklamadan önce kurulum planı: hedef dizinleri bir kez oluşturur,
+  // birimde yeterli boş alan olduğunu denetler ve büyük dosyaların
+  // .part'larını beklenen boyuta ayırır. false: yer yok, error doldurulur;
+  // görevler kuyruklanmamalıdır.
+  bool prepare(const std::vector<std::shared_ptr<DownloadTask>> &tasks,
+               std::string &error);
+
+  // Tüm işleri iptal eder (havuz çalışmaya devam eder)
+  void cancel();
+
+  // Bitmemiş iş var mı
+  bool isRunning() const;
+
+  // Doğrulanmış dosya dizini (ör. <mcDir>/cache/hash-index.txt)
+  void setHashIndexPath(const std::string &path);
+  // true: dizine güvenme, mevcut her dosyayı baştan hash'le
+  void setDeepVerify(bool on) { m_deepVerify = on; }
+
+  DownloadStats stats() const;
+
+  // Geçici hatalarda (timeout, 429/5xx, hash) görev başına deneme sınırı
+  void setMaxRetries(int n) { m_maxRetries = n; }
+
+  // expectedSize >= thresholdBytes olan dosyalar en fazla maxSegments
+  // paralel Range isteğiyle indirilir. thresholdBytes <= 0: kapalı.
+  void setChunking(long long thresholdBytes, int maxSegments) {
+    m_chunkThreshold = thresholdBytes;
+    m_chunkSegments = std::max(2, maxSegments);
+  }
+
+  // Linux'ta küçük dosyaları io_uring ile toplu yaz (varsayılan açık;
+  // çekirdek desteklemiyorsa kendiliğinden senkron yola döner)
+  void setIoUring(bool on) { m_useUring = on; }
+
+private:
+  struct Transfer;
+  struct ChunkJob;
+
+  static constexpr int kPriorityCount = 3;
+
+  // Aşama başına öncelik kuyruğu (sınıf başına FIFO, tek mutex + cv)
+  using Stage = TaskQueue<std::shared_ptr<DownloadTask>, kPriorityCount>;
+
+  void startWorkers();
+  void shutdown();
+  void verifyLoop();
+  void eventLoop();
+  void pushTask(Stage &stage, std::shared_ptr<DownloadTask> task);
+  // waitMs: <0 sonsuza dek bekle, 0 beklemeden dön
+  std::shared_ptr<DownloadTask> popTask(Stage &stage, int waitMs);
+  void scheduleRetry(std::shared_ptr<DownloadTask> task,
+                     RetryPolicy::Clock::time_point due);
+  void promoteDueRetries();
+  void wakeAll();
+  // Görevi ve aynı URL'yi bekleyen takipçilerini sonuçlandırır
+  void markDone(const DownloadTask &task, bool ok);
+  // Görevin kendi işine sonucu yazar; işin son görevi ise mandalı kurar
+  void credit(const DownloadTask &task, bool ok);
+  // İş bitti: bir kez, herhangi bir thread'den. finished main thread'e
+  // kuyruklanır, hash dizini bir event-loop'ta kaydedilir.
+  void latch(const std::shared_ptr<DownloadJob> &job);
+  // Main thread: son ilerleme, listeden çıkar, finished
+  void retireJob(const std::shared_ptr<DownloadJob> &job);
+  // Uçuştaki URL kaydını siler, takipçileri döndürür
+  std::vector<std::shared_ptr<DownloadTask>> release(const DownloadTask &task);
+  // Görevi bekleyen işlerin hepsi iptal edildi mi
+  bool abandoned(const DownloadTask &task);
+  RetryPolicy::Verdict chooseEndpoint(const DownloadTask &task,
+                                      std::string &url,
+                                      std::string &host,
+                                      RetryPolicy::Clock::time_point &retryAt);
+  bool wantsChunks(const DownloadTask &task) const;
+  void onTransferDone(Transfer &t, int curlCode);
+  bool finishTransfer(Transfer &t, int curlCode);
+  void commitDone(const DownloadTask &task, bool ok);
+  void onChunkDone(Transfer &t, int curlCode);
+  void finishChunkJob(ChunkJob &job);
+  // Ayna değiştir, geri çekilerek yeniden dene ya da başarısız say
+  void handleFailure(const std::shared_ptr<DownloadTask> &task,
+                     const std::string &url, bool retryable, long retryAfter);
+  static void setupEasy(Transfer &t);
+  // Hız sınırı token'ı; kısa beklemede gelmezse t duraklatılmak üzere
+  // işaretlenir ve false döner
+  static bool throttle(Transfer &t, size_t len);
+  static size_t writeCallback(char *ptr, size_t size, size_t nmemb,
+                              void *userdata);
+  std::string computeSha1(const std::string &filePath);
+  bool verifySha1(const std::string &filePath, const std::string &expected);
+  void pollProgress(); // Main thread: yalnızca ilerleme, asla bloklamaz
+  void reportProgress(DownloadJob &job,
+                      std::chrono::steady_clock::time_point now);
+
+  // Kuyruklar
+  Stage m_verifyStage; // Aşama 1: mevcut dosyaları sınıflandır (CPU/disk)
+  Stage m_netStage;    // Aşama 2: eksik dosyaları indir (ağ)
+
+  // Doğrulama + event-loop thread'leri
+  std::vector<std::thread> m_workers;
+  std::mutex m_workersMtx;
+  int m_maxTransfers;
+  int m_loopCount;
+  int m_verifyCount;
+  std::atomic<bool> m_stopping{false}; // Yalnızca yıkıcıda
+
+  // Bitmemiş işler (pollProgress sırayla raporlar)
+  std::vector<std::shared_ptr<DownloadJob>> m_jobs;
+  mutable std::mutex m_jobsMtx;
+  std::atomic<quint64> m_nextJobId{1};
+  // Biten iş oldu: hash dizini boşta bir event-loop'ta kaydedilsin
+  std::atomic<bool> m_indexDirty{false};
+
+  // Uçuştaki URL -> onu indiren görev (tekrarlar takipçi olarak eklenir)
+  std::unordered_map<std::string, std::shared_ptr<DownloadTask>> m_inflight;
+  std::mutex m_inflightMtx;
+
+  // Uyarlanabilir eşzamanlılık
+  std::unique_ptr<AimdController> m_aimd;
+  std::atomic<int> m_inFlight{0};
+
+  // Yeniden deneme: zamanı gelince ağ aşamasına geri itilen görevler
+  struct Delayed {
+    RetryPolicy::Clock::time_point due;
+    std::shared_ptr<DownloadTask> task;
+    bool operator>(const Delayed &o) const { return due > o.due; }
+  };
+  std::priority_queue<Delayed, std::vector<Delayed>, std::greater<Delayed>>
+      m_delayed;
+  std::mutex m_delayedMtx;
+  RetryPolicy m_retry;
+  std::atomic<int> m_maxRetries{4};
+
+  // Planda oluşturulan dizinler (event-loop yazıcıları mkdir atlar).
+  // Yalnızca sona eklenir; loop'lar m_plannedCount ile yenileri alır.
+  std::vector<std::string> m_plannedDirs;
+  std::unordered_set<std::string> m_plannedSeen;
+  std::atomic<size_t> m_plannedCount{0};
+  std::mutex m_plannedDirsMtx;
+
+  // Parçalı (Range) indirme
+  std::atomic<long long> m_chunkThreshold{8LL << 20};
+  std::atomic<int> m_chunkSegments{4};
+  std::atomic<bool> m_useUring{true};
+
+  // .part -> dest: toplu syncfs + atomik rename
+  std::unique_ptr<DurableCommit> m_commits;
+
+  // Delta kurulum: stat eşleşirse hash atlanır
+  HashIndex m_hashIndex;
+  std::atomic<bool> m_deepVerify{false};
 
   // Qt Timer
   std::unique_ptr<QTimer> m_pollTimer;
@@ -0,0 +1,173 @@
+#include "DurableCommit.h"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+
+#include <fcntl.h>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+DurableCommit::DurableCommit(size_t maxBatch,
+                             std::chrono::milliseconds maxAge)
+    : m_maxBatch(std::max<size_t>(1, maxBatch)), m_maxAge(maxAge) {}
+
+void DurableCommit::add(const std::string &tmpPath,
+                        const std::string &finalPath, Done done) {
+  std::lock_guard<std::mutex> lk(m_mtx);
+  if (m_pending.empty())
+    m_oldest = std::chrono::steady_clock::now();
+  m_pending.push_back({tmpPath, finalPath, std::move(done)});
+}
+
+bool DurableCommit::due(bool idle) const {
+  std::lock_guard<std::mutex> lk(m_mtx);
+  if (m_pending.empty())
+    return false;
+  return idle || m_pending.size() >= m_maxBatch ||
+         std::chrono::steady_clock::now() - m_oldest >= m_maxAge;
+}
+
+void DurableCommit::flush() {
+  std::vector<Entry> batch;
+  {
+    std::lock_guard<std::mutex> lk(m_mtx);
+    batch.swap(m_pending);
+  }
+  if (batch.empty())
+    return;
+
+  // 1. Veriler diske inmeden hiçbir dosya yerine taşınmaz
+  std::vector<std::string> paths;
+  paths.reserve(batch.size());
+  for (const auto &e : batch)
+    paths.push_back(e.tmpPath);
+  syncAll(paths);
+
+  // 2. Atomik yerleştirme
+  std::vector<bool> ok(batch.size());
+  paths.clear();
+  for (size_t i = 0; i < batch.size(); ++i) {
+    std::error_code ec;
+    fs::rename(batch[i].tmpPath, batch[i].finalPath, ec);
+    ok[i] = !ec;
+    if (ec) {
+      spdlog::error("Tasinamadi: {} ({})", batch[i].finalPath, ec.message());
+      fs::remove(batch[i].tmpPath, ec);
+    } else {
+      paths.push_back(batch[i].finalPath);
+    }
+  }
+
+  // 3. Dizin girdileri (rename'ler) kalıcı
+#ifdef __linux__
+  syncAll(paths);
+#else
+  std::vector<std::string> dirs;
+  for (const auto &p : paths) {
+    auto dir = fs::path(p).parent_path().string();
+    if (std::find(dirs.begin(), dirs.end(), dir) == dirs.end())
+      dirs.push_back(dir);
+  }
+  for (const auto &d : dirs)
+    syncDir(d);
+#endif
+
+  for (size_t i = 0; i < batch.size(); ++i)
+    if (batch[i].done)
+      batch[i].done(ok[i]);
+}
+
+bool DurableCommit::commitFile(const std::string &tmpPath,
+                               const std::string &finalPath) {
+  if (!syncFile(tmpPath))
+    return false;
+  std::error_code ec;
+  fs::rename(tmpPath, finalPath, ec);
+  if (ec) {
+    spdlog::error("Tasinamadi: {} ({})", finalPath, ec.message());
+    fs::remove(tmpPath, ec);
+    return false;
+  }
+  syncDir(fs::path(finalPath).parent_path().string());
+  return true;
+}
+
+bool DurableCommit::writeFile(const std::string &path,
+                              const std::string &data) {
+  std::error_code ec;
+  fs::create_directories(fs::path(path).parent_path(), ec);
+  std::string tmp = path + ".tmp";
+  {
+    std::ofstream ofs(tmp, std::ios::binary | std::ios::trunc);
+    if (!ofs)
+      return false;
+    ofs.write(data.data(), static_cast<std::streamsize>(data.size()));
+    if (!ofs) {
+      ofs.close();
+      fs::remove(tmp, ec);
+      return false;
+    }
+  }
+  return commitFile(tmp, path);
+}
+
+bool DurableCommit::syncFile(const std::string &path) {
+#ifdef _WIN32
+  int fd = _open(path.c_str(), _O_RDWR | _O_BINARY);
+  if (fd < 0)
+    return false;
+  bool ok = _commit(fd) == 0;
+  _close(fd);
+#else
+  int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    return false;
+  bool ok = ::fsync(fd) == 0;
+  ::close(fd);
+#endif
+  return ok;
+}
+
+void DurableCommit::syncDir(const std::string &dir) {
+#ifndef _WIN32
+  int fd = ::open(dir.empty() ? "." : dir.c_str(),
+                  O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (fd < 0)
+    return;
+  ::fsync(fd);
+  ::close(fd);
+#else
+  // NTFS'te rename meta verisi günlüklenir; dizin açılıp fsync'lenemez
+  (void)dir;
+#endif
+}
+
+void DurableCommit::syncAll(const std::vector<std::string> &paths) {
+#ifdef __linux__
+  std::vector<dev_t> seen;
+  for (const auto &p : paths) {
+    struct stat st;
+    if (::stat(p.c_str(), &st) != 0 ||
+        std::find(seen.begin(), seen.end(), st.st_dev) != seen.end())
+      continue;
+    seen.push_back(st.st_dev);
+    int fd = ::open(p.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+      continue;
+    ::syncfs(fd);
+    ::close(fd);
+  }
+#else
+  for (const auto &p : paths)
+    syncFile(p);
+#endif
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Çökmeye dayanıklı dosya yerleştirme. Her artefakt önce geçici dosyaya
+// (<dest>.part / .tmp) yazılır, verisi diske indirilir, sonra rename ile
+// atomik olarak yerine taşınır. Böylece hedef dosya varsa içeriği tamdır;
+// temiz olmayan kapanıştan sonra hızlı yol (hash dizini) yeniden
+// hash'lemeden dosyaya güvenebilir.
+//
+// İndirme hattında dosya başına fsync yerine toplu çalışılır: biriken
+// dosyalar için bir syncfs, ardından tüm rename'ler, ardından rename'leri
+// kalıcılaştıran ikinci bir syncfs.
+class DurableCommit {
+public:
+  using Done = std::function<void(bool ok)>;
+
+  explicit DurableCommit(
+      size_t maxBatch = 64,
+      std::chrono::milliseconds maxAge = std::chrono::milliseconds(250));
+
+  // tmpPath kapatılmış ve doğrulanmış olmalı. done, flush'ı yapan
+  // thread'de çağrılır.
+  void add(const std::string &tmpPath, const std::string &finalPath,
+           Done done);
+
+  // Toplu iş doldu, yeterince bekledi ya da çağıran boşta (idle)
+  bool due(bool idle) const;
+  void flush();
+
+  // Tek dosya: fsync + rename + dizin fsync
+  static bool commitFile(const std::string &tmpPath,
+                         const std::string &finalPath);
+  // data'yı <path>.tmp'ye yazıp commitFile ile yerine taşır
+  static bool writeFile(const std::string &path, const std::string &data);
+
+private:
+  struct Entry {
+    std::string tmpPath;
+    std::string finalPath;
+    Done done;
+  };
+
+  static bool syncFile(const std::string &path);
+  static void syncDir(const std::string &dir);
+  // Linux'ta dosyaların bulunduğu her dosya sistemi için bir syncfs;
+  // diğer platformlarda dosya başına fsync
+  static void syncAll(const std::vector<std::string> &paths);
+
+  size_t m_maxBatch;
+  std::chrono::milliseconds m_maxAge;
+
+  mutable std::mutex m_mtx;
+  std::vector<Entry> m_pending;
+  std::chrono::steady_clock::time_point m_oldest{};
+};
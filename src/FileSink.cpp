@@ -0,0 +1,258 @@
+#include "FileSink.h"
+
+#include <openssl/evp.h>
+
+#include <cerrno>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#ifdef _WIN32
+#include <io.h>
+#define sink_open _open
+#define sink_write _write
+#define sink_close _close
+#define sink_size _filelengthi64
+#define sink_truncate(fd, n) (_chsize_s(fd, n) == 0 ? 0 : -1)
+#define SINK_FLAGS (_O_WRONLY | _O_CREAT | _O_BINARY)
+#define SINK_APPEND_FLAGS (_O_WRONLY | _O_CREAT | _O_APPEND | _O_BINARY)
+#define SINK_RW_FLAGS (_O_RDWR | _O_CREAT | _O_BINARY)
+#else
+#include <sys/stat.h>
+#include <unistd.h>
+#define sink_open ::open
+#define sink_write ::write
+#define sink_close ::close
+#define sink_truncate ::ftruncate
+#define SINK_FLAGS (O_WRONLY | O_CREAT | O_CLOEXEC)
+#define SINK_APPEND_FLAGS (O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC)
+#define SINK_RW_FLAGS (O_RDWR | O_CREAT | O_CLOEXEC)
+static long long sink_size(int fd) {
+  struct stat st;
+  return ::fstat(fd, &st) == 0 ? static_cast<long long>(st.st_size) : -1;
+}
+#endif
+
+namespace fs = std::filesystem;
+
+// O_TRUNC yerine: kurulum planında ayrılmış (boyutu değiştirmeyen) bloklar
+// boş bir .part açılırken serbest bırakılmasın. Dizin ağacı da planda
+// kurulur; yalnızca eksikse oluşturulur.
+static int sink_open_fresh(const std::string &path, int flags) {
+  int fd = sink_open(path.c_str(), flags, 0644);
+  if (fd < 0 && errno == ENOENT) {
+    std::error_code ec;
+    fs::create_directories(fs::path(path).parent_path(), ec);
+    fd = sink_open(path.c_str(), flags, 0644);
+  }
+  if (fd >= 0 && sink_size(fd) != 0 && sink_truncate(fd, 0) != 0) {
+    sink_close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+FileSink::FileSink() : m_ctx(EVP_MD_CTX_new()) {}
+
+FileSink::~FileSink() {
+  if (m_fd >= 0)
+    sink_close(m_fd);
+  EVP_MD_CTX_free(m_ctx);
+}
+
+bool FileSink::open(const std::string &path) {
+  m_path = path;
+  m_written = 0;
+  m_fd = sink_open_fresh(path, SINK_FLAGS);
+  if (m_fd < 0)
+    return false;
+  EVP_DigestInit_ex(m_ctx, EVP_sha1(), nullptr);
+  return true;
+}
+
+bool FileSink::openBuffered(const std::string &path) {
+  m_path = path;
+  m_written = 0;
+  m_buffered = true;
+  m_buffer.clear();
+  EVP_DigestInit_ex(m_ctx, EVP_sha1(), nullptr);
+  return true;
+}
+
+std::string FileSink::takeBuffer() {
+  m_buffered = false;
+  return std::move(m_buffer);
+}
+
+bool FileSink::resume(const std::string &path) {
+  m_path = path;
+  m_written = 0;
+  EVP_DigestInit_ex(m_ctx, EVP_sha1(), nullptr);
+
+  // Önceki oturumda yazılan kısım hash'e dahil edilmeli
+  {
+    std::ifstream ifs(path, std::ios::binary);
+    char buf[65536];
+    while (ifs.read(buf, sizeof(buf)) || ifs.gcount() > 0) {
+      EVP_DigestUpdate(m_ctx, buf, static_cast<size_t>(ifs.gcount()));
+      m_written += ifs.gcount();
+    }
+  }
+
+  m_fd = sink_open(path.c_str(), SINK_APPEND_FLAGS, 0644);
+  return m_fd >= 0;
+}
+
+bool FileSink::write(const char *data, size_t len) {
+  if (m_buffered) {
+    EVP_DigestUpdate(m_ctx, data, len);
+    m_buffer.append(data, len);
+    m_written += static_cast<long long>(len);
+    return true;
+  }
+  if (m_fd < 0)
+    return false;
+  EVP_DigestUpdate(m_ctx, data, len);
+  while (len > 0) {
+    auto n = sink_write(m_fd, data, static_cast<unsigned>(len));
+    if (n <= 0)
+      return false;
+    data += n;
+    len -= static_cast<size_t>(n);
+    m_written += n;
+  }
+  return true;
+}
+
+bool FileSink::close() {
+  if (m_buffered)
+    return true;
+  if (m_fd < 0)
+    return false;
+  bool ok = sink_close(m_fd) == 0;
+  m_fd = -1;
+  return ok;
+}
+
+bool FileSink::commit(const std::string &finalPath) {
+  if (m_fd >= 0 && !close())
+    return false;
+  std::error_code ec;
+  fs::rename(m_path, finalPath, ec);
+  return !ec;
+}
+
+void FileSink::discard() {
+  m_buffered = false;
+  m_buffer.clear();
+  close();
+  if (!m_path.empty()) {
+    std::error_code ec;
+    fs::remove(m_path, ec);
+  }
+}
+
+std::string FileSink::sha1Hex() {
+  unsigned char hash[EVP_MAX_MD_SIZE];
+  unsigned int hlen = 0;
+  EVP_DigestFinal_ex(m_ctx, hash, &hlen);
+  std::ostringstream ss;
+  for (unsigned int i = 0; i < hlen; ++i)
+    ss << std::hex << std::setfill('0') << std::setw(2) << (int)hash[i];
+  return ss.str();
+}
+
+// ── RangeSink ────────────────────────────────────────────
+RangeSink::~RangeSink() {
+  if (m_fd >= 0)
+    sink_close(m_fd);
+}
+
+bool RangeSink::open(const std::string &path, long long size) {
+  m_path = path;
+  m_fd = sink_open_fresh(path, SINK_RW_FLAGS);
+  if (m_fd < 0)
+    return false;
+#ifdef _WIN32
+  bool sized = _chsize_s(m_fd, size) == 0;
+#elif defined(__linux__)
+  // Önce gerçek blok ayırmayı dene; desteklemeyen dosya sistemlerinde
+  // seyrek dosya yeterli
+  bool sized = ::posix_fallocate(m_fd, 0, size) == 0 ||
+               ::ftruncate(m_fd, size) == 0;
+#else
+  bool sized = ::ftruncate(m_fd, size) == 0; // macOS: posix_fallocate yok
+#endif
+  if (!sized) {
+    discard();
+    return false;
+  }
+  return true;
+}
+
+bool RangeSink::writeAt(long long offset, const char *data, size_t len) {
+  if (m_fd < 0)
+    return false;
+  while (len > 0) {
+#ifdef _WIN32
+    int n;
+    {
+      std::lock_guard<std::mutex> lk(m_seekMtx);
+      if (_lseeki64(m_fd, offset, SEEK_SET) < 0)
+        return false;
+      n = _write(m_fd, data, static_cast<unsigned>(len));
+    }
+#else
+    auto n = ::pwrite(m_fd, data, len, offset);
+#endif
+    if (n <= 0)
+      return false;
+    data += n;
+    len -= static_cast<size_t>(n);
+    offset += n;
+  }
+  return true;
+}
+
+bool RangeSink::close() {
+  if (m_fd < 0)
+    return false;
+  bool ok = sink_close(m_fd) == 0;
+  m_fd = -1;
+  return ok;
+}
+
+bool RangeSink::commit(const std::string &finalPath) {
+  if (m_fd >= 0 && !close())
+    return false;
+  std::error_code ec;
+  fs::rename(m_path, finalPath, ec);
+  return !ec;
+}
+
+void RangeSink::discard() {
+  if (m_fd >= 0)
+    close();
+  if (!m_path.empty()) {
+    std::error_code ec;
+    fs::remove(m_path, ec);
+  }
+}
+
+bool RangeSink::reserve(const std::string &path, long long size) {
+#ifdef __linux__
+  int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC, 0644);
+  if (fd < 0)
+    return true; // Ön ayırma yalnızca iyileştirme
+  bool full = ::fallocate(fd, FALLOC_FL_KEEP_SIZE, 0, size) != 0 &&
+              (errno == ENOSPC || errno == EDQUOT);
+  ::close(fd);
+  return !full;
+#else
+  (void)path;
+  (void)size;
+  return true;
+#endif
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <mutex>
+#include <string>
+
+typedef struct evp_md_ctx_st EVP_MD_CTX;
+
+// İndirilen gövdeyi parça parça diske yazar ve aynı anda SHA-1'ini
+// hesaplar. Bellek kullanımı dosya boyutundan bağımsızdır; indirme
+// bittikten sonra dosyayı yeniden okuyup hash'lemeye gerek kalmaz.
+class FileSink {
+public:
+  FileSink();
+  ~FileSink();
+
+  FileSink(const FileSink &) = delete;
+  FileSink &operator=(const FileSink &) = delete;
+
+  bool open(const std::string &path);   // Sıfırdan yaz (truncate)
+  bool resume(const std::string &path); // Var olan baytları hash'le, sona ekle
+  // Gövdeyi diske değil belleğe topla; takeBuffer() ile toplu yazıcıya
+  // (UringWriter) verilir. path yalnızca kayıt için tutulur.
+  bool openBuffered(const std::string &path);
+  bool write(const char *data, size_t len);
+  bool close();
+  bool commit(const std::string &finalPath); // Kapat ve yerine taşı
+  void discard(); // Kapat ve yarım dosyayı sil
+
+  bool isOpen() const { return m_fd >= 0 || m_buffered; }
+  bool isBuffered() const { return m_buffered; }
+  std::string takeBuffer();
+  long long written() const { return m_written; }
+  const std::string &path() const { return m_path; }
+
+  // Yazılan tüm baytların SHA-1'i (hex). close() sonrası çağrılır.
+  std::string sha1Hex();
+
+private:
+  int m_fd = -1;
+  EVP_MD_CTX *m_ctx = nullptr;
+  std::string m_path;
+  long long m_written = 0;
+  bool m_buffered = false;
+  std::string m_buffer;
+};
+
+// Aralıklı (Range) paralel indirme için önceden boyutlandırılmış dosya.
+// Her parça kendi ofsetine yazar; hash, parçalar birleştikten sonra bir
+// kez hesaplanır. writeAt farklı thread'lerden eşzamanlı çağrılabilir.
+class RangeSink {
+public:
+  RangeSink() = default;
+  ~RangeSink();
+
+  RangeSink(const RangeSink &) = delete;
+  RangeSink &operator=(const RangeSink &) = delete;
+
+  bool open(const std::string &path, long long size); // Truncate + yer ayır
+  bool writeAt(long long offset, const char *data, size_t len);
+  bool close();
+  bool commit(const std::string &finalPath); // Kapat ve yerine taşı
+  void discard(); // Kapat ve yarım dosyayı sil
+
+  bool isOpen() const { return m_fd >= 0; }
+  const std::string &path() const { return m_path; }
+
+  // path için size bayt blok ayırır, dosya boyutunu değiştirmez (Linux:
+  // FALLOC_FL_KEEP_SIZE); .part'tan devam etme mantığı bozulmaz.
+  // false yalnızca disk/kota doluysa; desteklenmiyorsa true.
+  static bool reserve(const std::string &path, long long size);
+
+private:
+  int m_fd = -1;
+  std::string m_path;
+#ifdef _WIN32
+  std::mutex m_seekMtx; // _lseeki64 + _write çifti atomik değil
+#endif
+};
@@ -0,0 +1,114 @@
+#include "HashIndex.h"
+
+#include <spdlog/spdlog.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
+
+namespace fs = std::filesystem;
+
+// Satır formatı: <sha1> <size> <mtime_ns> <inode> <path>
+void HashIndex::load(const std::string &indexPath) {
+  std::lock_guard<std::mutex> lk(m_mtx);
+  m_indexPath = indexPath;
+  m_entries.clear();
+  m_dirty = false;
+
+  std::ifstream ifs(indexPath);
+  std::string line;
+  while (std::getline(ifs, line)) {
+    std::istringstream ss(line);
+    Entry e;
+    std::string path;
+    if (!(ss >> e.sha1 >> e.size >> e.mtimeNs >> e.inode))
+      continue;
+    ss.get(); // ayraç boşluk
+    std::getline(ss, path);
+    if (!path.empty())
+      m_entries[path] = e;
+  }
+  spdlog::info("Hash dizini: {} kayit", m_entries.size());
+}
+
+bool HashIndex::save() {
+  std::lock_guard<std::mutex> lk(m_mtx);
+  if (!m_dirty || m_indexPath.empty())
+    return true;
+
+  std::error_code ec;
+  fs::create_directories(fs::path(m_indexPath).parent_path(), ec);
+  std::string tmp = m_indexPath + ".tmp";
+  {
+    std::ofstream ofs(tmp, std::ios::trunc);
+    if (!ofs)
+      return false;
+    for (const auto &[path, e] : m_entries)
+      ofs << e.sha1 << ' ' << e.size << ' ' << e.mtimeNs << ' ' << e.inode
+          << ' ' << path << '\n';
+    if (!ofs)
+      return false;
+  }
+  fs::rename(tmp, m_indexPath, ec);
+  if (ec)
+    return false;
+  m_dirty = false;
+  return true;
+}
+
+bool HashIndex::statFile(const std::string &path, Entry &out) {
+#ifdef _WIN32
+  std::error_code ec;
+  out.size = static_cast<long long>(fs::file_size(path, ec));
+  if (ec)
+    return false;
+  out.mtimeNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    fs::last_write_time(path, ec).time_since_epoch())
+                    .count();
+  out.inode = 0;
+  return !ec;
+#else
+  struct stat st;
+  if (::stat(path.c_str(), &st) != 0 || !S_ISREG(st.st_mode))
+    return false;
+  out.size = static_cast<long long>(st.st_size);
+  out.mtimeNs = static_cast<long long>(st.st_mtim.tv_sec) * 1000000000LL +
+                st.st_mtim.tv_nsec;
+  out.inode = static_cast<unsigned long long>(st.st_ino);
+  return true;
+#endif
+}
+
+bool HashIndex::matches(const std::string &path, const std::string &sha1) {
+  Entry cur;
+  if (!statFile(path, cur))
+    return false;
+  std::lock_guard<std::mutex> lk(m_mtx);
+  auto it = m_entries.find(path);
+  if (it == m_entries.end())
+    return false;
+  const Entry &e = it->second;
+  return e.sha1 == sha1 && e.size == cur.size && e.mtimeNs == cur.mtimeNs &&
+         e.inode == cur.inode;
+}
+
+void HashIndex::record(const std::string &path, const std::string &sha1) {
+  Entry e;
+  if (!statFile(path, e))
+    return;
+  e.sha1 = sha1;
+  std::lock_guard<std::mutex> lk(m_mtx);
+  m_entries[path] = std::move(e);
+  m_dirty = true;
+}
+
+void HashIndex::forget(const std::string &path) {
+  std::lock_guard<std::mutex> lk(m_mtx);
+  if (m_entries.erase(path) > 0)
+    m_dirty = true;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// Daha önce doğrulanmış dosyaların kalıcı dizini:
+//   path -> (size, mtime_ns, inode, sha1)
+// stat bilgisi hâlâ tutuyorsa dosya yeniden hash'lenmeden güvenilir kabul
+// edilir. Delta kurulumlarda GB'larca okuma/hash'leme atlanır.
+class HashIndex {
+public:
+  void load(const std::string &indexPath);
+  bool save();
+
+  // Dosyanın stat'ı kayıtlı olanla aynı ve sha1 eşleşiyorsa true
+  bool matches(const std::string &path, const std::string &sha1);
+  // Az önce doğrulanmış (ya da yazılmış) dosyayı kaydet
+  void record(const std::string &path, const std::string &sha1);
+  void forget(const std::string &path);
+
+private:
+  struct Entry {
+    long long size = 0;
+    long long mtimeNs = 0;
+    unsigned long long inode = 0;
+    std::string sha1;
+  };
+
+  static bool statFile(const std::string &path, Entry &out);
+
+  std::string m_indexPath;
+  std::unordered_map<std::string, Entry> m_entries;
+  std::mutex m_mtx;
+  bool m_dirty = false;
+};
@@ -0,0 +1,196 @@
+#include "HttpCache.h"
+
+#include <curl/curl.h>
+#include <nlohmann/json.hpp>
+#include <openssl/evp.h>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+using json = nlohmann::json;
+namespace fs = std::filesystem;
+
+static long long unixNow() {
+  return std::chrono::duration_cast<std::chrono::seconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+bool HttpCache::Entry::fresh() const {
+  return maxAge > 0 && unixNow() < storedAt + maxAge;
+}
+
+void HttpCache::setRoot(const std::string &dir) {
+  std::lock_guard<std::mutex> lk(m_mtx);
+  m_root = dir;
+  if (m_root.empty())
+    return;
+  std::error_code ec;
+  fs::create_directories(m_root, ec);
+}
+
+bool HttpCache::enabled() const {
+  std::lock_guard<std::mutex> lk(m_mtx);
+  return !m_root.empty();
+}
+
+std::string HttpCache::pathFor(const std::string &url) const {
+  unsigned char md[EVP_MAX_MD_SIZE];
+  unsigned int len = 0;
+  EVP_Digest(url.data(), url.size(), md, &len, EVP_sha1(), nullptr);
+  static const char *hex = "0123456789abcdef";
+  std::string name;
+  for (unsigned int i = 0; i < len; ++i) {
+    name += hex[md[i] >> 4];
+    name += hex[md[i] & 0xf];
+  }
+  return m_root + "/" + name;
+}
+
+bool HttpCache::load(const std::string &url, Entry &out) const {
+  std::lock_guard<std::mutex> lk(m_mtx);
+  if (m_root.empty())
+    return false;
+  std::ifstream ifs(pathFor(url), std::ios::binary);
+  std::string line;
+  if (!ifs || !std::getline(ifs, line))
+    return false;
+  auto meta = json::parse(line, nullptr, false);
+  // sha1 çakışması ya da yarım kalmış yazım: ıska
+  if (meta.is_discarded() || meta.value("url", "") != url)
+    return false;
+  std::string body((std::istreambuf_iterator<char>(ifs)),
+                   std::istreambuf_iterator<char>());
+  if (static_cast<long long>(body.size()) != meta.value("size", -1LL))
+    return false;
+  out.etag = meta.value("etag", "");
+  out.lastModified = meta.value("last_modified", "");
+  out.storedAt = meta.value("stored_at", 0LL);
+  out.maxAge = meta.value("max_age", 0LL);
+  out.body = std::move(body);
+  return true;
+}
+
+void HttpCache::write(const std::string &url, const Entry &e) {
+  std::lock_guard<std::mutex> lk(m_mtx);
+  if (m_root.empty())
+    return;
+  json meta = {{"url", url},
+               {"etag", e.etag},
+               {"last_modified", e.lastModified},
+               {"stored_at", e.storedAt},
+               {"max_age", e.maxAge},
+               {"size", static_cast<long long>(e.body.size())}};
+  std::string path = pathFor(url);
+  std::string tmp = path + ".tmp";
+  std::error_code ec;
+  {
+    std::ofstream ofs(tmp, std::ios::binary | std::ios::trunc);
+    if (!ofs)
+      return;
+    ofs << meta.dump() << '\n';
+    ofs.write(e.body.data(), static_cast<std::streamsize>(e.body.size()));
+    if (!ofs) {
+      ofs.close();
+      fs::remove(tmp, ec);
+      return;
+    }
+  }
+  fs::rename(tmp, path, ec);
+  if (ec)
+    fs::remove(tmp, ec);
+}
+
+static std::string header(const HttpHeaders &h, const char *name) {
+  auto it = h.find(name);
+  return it == h.end() ? std::string() : it->second;
+}
+
+void HttpCache::store(const std::string &url, const HttpResponse &r) {
+  Entry e;
+  if (!freshness(r.header, e.maxAge)) {
+    std::lock_guard<std::mutex> lk(m_mtx);
+    std::error_code ec;
+    if (!m_root.empty())
+      fs::remove(pathFor(url), ec);
+    return;
+  }
+  e.etag = header(r.header, "ETag");
+  e.lastModified = header(r.header, "Last-Modified");
+  e.storedAt = unixNow();
+  e.body = r.text;
+  write(url, e);
+}
+
+void HttpCache::refresh(const std::string &url, Entry &e,
+                        const HttpResponse &r) {
+  // 304 başlıkları saklı olanların yerini alır
+  std::string etag = header(r.header, "ETag");
+  if (!etag.empty())
+    e.etag = etag;
+  std::string lastModified = header(r.header, "Last-Modified");
+  if (!lastModified.empty())
+    e.lastModified = lastModified;
+  if (!freshness(r.header, e.maxAge))
+    e.maxAge = 0;
+  e.storedAt = unixNow();
+  write(url, e);
+}
+
+bool HttpCache::freshness(const HttpHeaders &h, long long &maxAge) {
+  maxAge = 0;
+  bool explicitAge = false;
+  bool noCache = false;
+  std::string cc = header(h, "Cache-Control");
+  std::transform(cc.begin(), cc.end(), cc.begin(),
+                 [](unsigned char c) { return std::tolower(c); });
+  size_t pos = 0;
+  while (pos < cc.size()) {
+    size_t end = std::min(cc.find(',', pos), cc.size());
+    std::string d = cc.substr(pos, end - pos);
+    pos = end + 1;
+    d.erase(0, d.find_first_not_of(" \t"));
+    d.erase(d.find_last_not_of(" \t") + 1);
+    if (d == "no-store")
+      return false;
+    if (d == "no-cache") {
+      noCache = true;
+    } else if (d.compare(0, 8, "max-age=") == 0) {
+      try {
+        maxAge = std::stoll(d.substr(8));
+        explicitAge = true;
+      } catch (...) {
+      }
+    }
+  }
+  if (noCache) {
+    maxAge = 0;
+    return true;
+  }
+
+  // max-age yoksa Expires - Date
+  std::string expires = header(h, "Expires");
+  if (!explicitAge && !expires.empty()) {
+    time_t exp = curl_getdate(expires.c_str(), nullptr);
+    std::string date = header(h, "Date");
+    time_t now = date.empty() ? std::time(nullptr)
+                              : curl_getdate(date.c_str(), nullptr);
+    if (exp > 0 && now > 0 && exp > now)
+      maxAge = exp - now;
+  }
+
+  // Ara önbellekte geçen süre
+  try {
+    std::string age = header(h, "Age");
+    if (!age.empty())
+      maxAge -= std::stoll(age);
+  } catch (...) {
+  }
+  maxAge = std::max(0LL, maxAge);
+  return true;
+}
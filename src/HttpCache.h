@@ -0,0 +1,48 @@
+#pragma once
+
+#include "HttpClient.h"
+
+#include <mutex>
+#include <string>
+
+// Meta veri yanıtları için kalıcı HTTP önbelleği (URL anahtarlı):
+//   <mcDir>/cache/http/<sha1(url)>
+// Dosyanın ilk satırı JSON başlık (url, ETag, Last-Modified, saklanma
+// zamanı, tazelik süresi, gövde boyu), ardından gövde gelir. Cache-Control
+// (max-age, no-cache, no-store) ve Age/Expires'a uyulur; süresi dolan kayıt
+// If-None-Match / If-Modified-Since ile yeniden doğrulanır, değişmediyse
+// sunucu 304 ile gövdesiz yanıt verir.
+//
+// Yazımlar geçici dosya + rename ile yapılır (fsync yok: kayıp ya da
+// yarım kayıt yalnızca bir ıska demektir). Thread-safe.
+class HttpCache {
+public:
+  struct Entry {
+    std::string etag;
+    std::string lastModified;
+    std::string body;
+    long long storedAt = 0; // Unix zamanı (sn)
+    long long maxAge = 0;   // sn; 0: her kullanımda yeniden doğrula
+
+    bool fresh() const;
+  };
+
+  // Boş: önbellek kapalı
+  void setRoot(const std::string &dir);
+  bool enabled() const;
+
+  bool load(const std::string &url, Entry &out) const;
+  // 200 yanıtı: Cache-Control no-store ise mevcut kayıt da silinir
+  void store(const std::string &url, const HttpResponse &r);
+  // 304 yanıtı: gövde korunur, doğrulayıcılar ve tazelik yenilenir
+  void refresh(const std::string &url, Entry &e, const HttpResponse &r);
+
+private:
+  std::string pathFor(const std::string &url) const;
+  void write(const std::string &url, const Entry &e);
+  // Yanıt başlıklarından tazelik süresi (sn); no-store'da false
+  static bool freshness(const HttpHeaders &h, long long &maxAge);
+
+  mutable std::mutex m_mtx;
+  std::string m_root;
+};
@@ -0,0 +1,326 @@
+#include "HttpClient.h"
+#include "HttpCache.h"
+
+#include <curl/curl.h>
+
+#include <algorithm>
+#include <cctype>
+
+static const char *kUserAgent = "MixLauncher/2.0 (contact@minecraftmix)";
+static constexpr long kConnectTimeoutMs = 15000;
+static constexpr long kStallSeconds = 30; // Bu süre veri gelmezse kes
+static constexpr size_t kMaxIdle = 16;
+static constexpr int kPollMs = 50; // İptal en geç bu aralıkta fark edilir
+
+bool HttpHeaderLess::operator()(const std::string &a,
+                                const std::string &b) const {
+  return std::lexicographical_compare(
+      a.begin(), a.end(), b.begin(), b.end(), [](char x, char y) {
+        return std::tolower(static_cast<unsigned char>(x)) <
+               std::tolower(static_cast<unsigned char>(y));
+      });
+}
+
+// CURLSH ve paylaşılan veri türü başına kilit
+struct HttpClient::Share {
+  CURLSH *handle = nullptr;
+  std::mutex locks[CURL_LOCK_DATA_LAST];
+};
+
+static void shareLock(CURL *, curl_lock_data data, curl_lock_access,
+                      void *userp) {
+  static_cast<std::mutex *>(userp)[data].lock();
+}
+
+static void shareUnlock(CURL *, curl_lock_data data, void *userp) {
+  static_cast<std::mutex *>(userp)[data].unlock();
+}
+
+HttpClient &HttpClient::instance() {
+  static HttpClient client;
+  return client;
+}
+
+HttpClient::HttpClient()
+    : m_share(std::make_unique<Share>()),
+      m_cache(std::make_unique<HttpCache>()) {
+  curl_global_init(CURL_GLOBAL_DEFAULT);
+  m_share->handle = curl_share_init();
+  if (!m_share->handle)
+    return;
+  curl_share_setopt(m_share->handle, CURLSHOPT_LOCKFUNC, &shareLock);
+  curl_share_setopt(m_share->handle, CURLSHOPT_UNLOCKFUNC, &shareUnlock);
+  curl_share_setopt(m_share->handle, CURLSHOPT_USERDATA, m_share->locks);
+  curl_share_setopt(m_share->handle, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+  curl_share_setopt(m_share->handle, CURLSHOPT_SHARE,
+                    CURL_LOCK_DATA_SSL_SESSION);
+}
+
+HttpClient::~HttpClient() {
+  for (Slot &slot : m_idle) {
+    curl_easy_cleanup(slot.easy);
+    curl_multi_cleanup(slot.multi);
+  }
+  if (m_share->handle)
+    curl_share_cleanup(m_share->handle);
+}
+
+const char *HttpClient::userAgent() { return kUserAgent; }
+
+void HttpClient::setCacheDir(const std::string &dir) {
+  m_cache->setRoot(dir);
+}
+
+void HttpClient::configure(void *easy, bool verifyTls) const {
+  if (m_share->handle)
+    curl_easy_setopt(easy, CURLOPT_SHARE, m_share->handle);
+  curl_easy_setopt(easy, CURLOPT_USERAGENT, kUserAgent);
+  curl_easy_setopt(easy, CURLOPT_FOLLOWLOCATION, 1L);
+  curl_easy_setopt(easy, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+  curl_easy_setopt(easy, CURLOPT_TCP_KEEPALIVE, 1L);
+  curl_easy_setopt(easy, CURLOPT_NOSIGNAL, 1L);
+  curl_easy_setopt(easy, CURLOPT_SSL_VERIFYPEER, verifyTls ? 1L : 0L);
+  curl_easy_setopt(easy, CURLOPT_SSL_VERIFYHOST, verifyTls ? 2L : 0L);
+  // Toplam süre sınırı yok (büyük dosyalar yavaş hatta da bitebilsin):
+  // bağlantı ve "veri gelmiyor" sınırı kullanılır
+  curl_easy_setopt(easy, CURLOPT_CONNECTTIMEOUT_MS, kConnectTimeoutMs);
+  curl_easy_setopt(easy, CURLOPT_LOW_SPEED_LIMIT, 1L);
+  curl_easy_setopt(easy, CURLOPT_LOW_SPEED_TIME, kStallSeconds);
+}
+
+HttpResponse HttpClient::get(const std::string &url,
+                             const CancelToken *cancel) {
+  HttpOptions opt;
+  opt.cancel = cancel;
+  return perform(Method::Get, url, opt, nullptr);
+}
+
+HttpResponse HttpClient::get(const std::string &url, const HttpOptions &opt) {
+  return perform(Method::Get, url, opt, nullptr);
+}
+
+HttpResponse HttpClient::head(const std::string &url,
+                              const HttpOptions &opt) {
+  return perform(Method::Head, url, opt, nullptr);
+}
+
+HttpResponse HttpClient::post(const std::string &url, const std::string &body,
+                              const HttpOptions &opt) {
+  return perform(Method::Post, url, opt, &body);
+}
+
+HttpClient::Slot HttpClient::acquire() {
+  {
+    std::lock_guard<std::mutex> lk(m_poolMtx);
+    if (!m_idle.empty()) {
+      Slot slot = m_idle.back();
+      m_idle.pop_back();
+      return slot;
+    }
+  }
+  Slot slot{curl_multi_init(), curl_easy_init()};
+  if (!slot.multi || !slot.easy) {
+    curl_easy_cleanup(slot.easy);
+    curl_multi_cleanup(slot.multi);
+    return {};
+  }
+  return slot;
+}
+
+void HttpClient::release(Slot slot) {
+  // Seçenekler sıfırlanır; açık bağlantılar multi'nin havuzunda kalır
+  curl_easy_reset(slot.easy);
+  std::lock_guard<std::mutex> lk(m_poolMtx);
+  if (m_idle.size() < kMaxIdle) {
+    m_idle.push_back(slot);
+    return;
+  }
+  curl_easy_cleanup(slot.easy);
+  curl_multi_cleanup(slot.multi);
+}
+
+namespace {
+struct Call {
+  HttpResponse *response;
+  const HttpOptions *opt;
+};
+} // namespace
+
+static size_t onBody(char *ptr, size_t size, size_t nmemb, void *userdata) {
+  auto *c = static_cast<Call *>(userdata);
+  size_t n = size * nmemb;
+  if (c->opt->sink)
+    return c->opt->sink(ptr, n) ? n : 0;
+  c->response->text.append(ptr, n);
+  return n;
+}
+
+static size_t onHeader(char *ptr, size_t size, size_t nmemb, void *userdata) {
+  auto *r = static_cast<HttpResponse *>(userdata);
+  size_t n = size * nmemb;
+  std::string line(ptr, n);
+  // Yönlendirmede yeni yanıt başlar: yalnızca sonuncunun başlıkları kalır
+  if (line.compare(0, 5, "HTTP/") == 0) {
+    r->header.clear();
+    return n;
+  }
+  auto colon = line.find(':');
+  if (colon == std::string::npos)
+    return n;
+  auto first = line.find_first_not_of(" \t", colon + 1);
+  auto last = line.find_last_not_of(" \t\r\n");
+  r->header[line.substr(0, colon)] =
+      first == std::string::npos || last < first
+          ? std::string()
+          : line.substr(first, last - first + 1);
+  return n;
+}
+
+// Sorgu parametreleri URL-encode edilip eklenir
+static std::string withQuery(
+    const std::string &url,
+    const std::vector<std::pair<std::string, std::string>> &params) {
+  std::string full = url;
+  for (size_t i = 0; i < params.size(); ++i) {
+    const auto &p = params[i];
+    char *k = curl_easy_escape(nullptr, p.first.data(),
+                               static_cast<int>(p.first.size()));
+    char *v = curl_easy_escape(nullptr, p.second.data(),
+                               static_cast<int>(p.second.size()));
+    full += i == 0 && url.find('?') == std::string::npos ? '?' : '&';
+    full += std::string(k ? k : "") + "=" + (v ? v : "");
+    curl_free(k);
+    curl_free(v);
+  }
+  return full;
+}
+
+HttpResponse HttpClient::perform(Method method, const std::string &url,
+                                 const HttpOptions &opt,
+                                 const std::string *body) {
+  std::string full = withQuery(url, opt.params);
+  if (method != Method::Get || opt.sink)
+    return transfer(method, full, opt, body);
+
+  // Aynı istek uçuştaysa onun yanıtı beklenir
+  bool cached = opt.cache && m_cache->enabled();
+  std::string key = full;
+  for (const auto &h : opt.headers)
+    key += "\n" + h.first + ": " + h.second;
+  if (cached)
+    key += "\n(cache)";
+  if (!opt.verifyTls)
+    key += "\n(insecure)";
+  return m_gets.run(
+      key,
+      [&] {
+        return cached ? cachedGet(full, opt)
+                      : transfer(method, full, opt, body);
+      },
+      opt.cancel);
+}
+
+HttpResponse HttpClient::cachedGet(const std::string &url,
+                                   const HttpOptions &opt) {
+  HttpCache::Entry e;
+  bool have = m_cache->load(url, e);
+  if (have && e.fresh()) {
+    HttpResponse r;
+    r.status_code = 200;
+    r.text = std::move(e.body);
+    return r;
+  }
+
+  HttpOptions conditional = opt;
+  if (have) {
+    if (!e.etag.empty())
+      conditional.headers["If-None-Match"] = e.etag;
+    if (!e.lastModified.empty())
+      conditional.headers["If-Modified-Since"] = e.lastModified;
+  }
+  auto r = transfer(Method::Get, url, conditional, nullptr);
+  if (r.status_code == 304 && have) {
+    m_cache->refresh(url, e, r);
+    r.status_code = 200;
+    r.text = std::move(e.body);
+  } else if (r.status_code == 200) {
+    m_cache->store(url, r);
+  }
+  return r;
+}
+
+HttpResponse HttpClient::transfer(Method method, const std::string &url,
+                                  const HttpOptions &opt,
+                                  const std::string *body) {
+  HttpResponse r;
+  if (opt.cancel && opt.cancel->cancelled()) {
+    r.error = "cancelled";
+    return r;
+  }
+  Slot slot = acquire();
+  if (!slot.easy) {
+    r.error = "curl_easy_init";
+    return r;
+  }
+  CURL *easy = slot.easy;
+
+  configure(easy, opt.verifyTls);
+  curl_easy_setopt(easy, CURLOPT_URL, url.c_str());
+  curl_slist *headers = nullptr;
+  for (const auto &h : opt.headers)
+    headers = curl_slist_append(headers, (h.first + ": " + h.second).c_str());
+  if (headers)
+    curl_easy_setopt(easy, CURLOPT_HTTPHEADER, headers);
+  // Bellekteki meta veri (JSON) sıkıştırılmış alınabilir
+  if (!opt.sink)
+    curl_easy_setopt(easy, CURLOPT_ACCEPT_ENCODING, "");
+  if (opt.timeoutMs > 0)
+    curl_easy_setopt(easy, CURLOPT_TIMEOUT_MS, opt.timeoutMs);
+  if (method == Method::Head)
+    curl_easy_setopt(easy, CURLOPT_NOBODY, 1L);
+  if (method == Method::Post) {
+    curl_easy_setopt(easy, CURLOPT_POSTFIELDS, body->data());
+    curl_easy_setopt(easy, CURLOPT_POSTFIELDSIZE_LARGE,
+                     static_cast<curl_off_t>(body->size()));
+  }
+
+  Call call{&r, &opt};
+  curl_easy_setopt(easy, CURLOPT_WRITEFUNCTION, &onBody);
+  curl_easy_setopt(easy, CURLOPT_WRITEDATA, &call);
+  curl_easy_setopt(easy, CURLOPT_HEADERFUNCTION, &onHeader);
+  curl_easy_setopt(easy, CURLOPT_HEADERDATA, &r);
+
+  // curl_easy_perform yerine kısa aralıklı poll: durmuş bir bağlantıda da
+  // iptal kPollMs içinde fark edilir (XFERINFO ancak saniyede bir çağrılır)
+  CURLM *multi = slot.multi;
+  curl_multi_add_handle(multi, easy);
+  CURLcode rc = CURLE_OK;
+  int running = 1;
+  while (running > 0) {
+    if (curl_multi_perform(multi, &running) != CURLM_OK) {
+      rc = CURLE_FAILED_INIT;
+      break;
+    }
+    if (running == 0)
+      break;
+    if (opt.cancel && opt.cancel->cancelled()) {
+      rc = CURLE_ABORTED_BY_CALLBACK;
+      break;
+    }
+    curl_multi_poll(multi, nullptr, 0, kPollMs, nullptr);
+  }
+  int pending = 0;
+  while (CURLMsg *msg = curl_multi_info_read(multi, &pending))
+    if (msg->msg == CURLMSG_DONE && rc == CURLE_OK)
+      rc = msg->data.result;
+  curl_multi_remove_handle(multi, easy);
+
+  if (rc == CURLE_OK)
+    curl_easy_getinfo(easy, CURLINFO_RESPONSE_CODE, &r.status_code);
+  else
+    r.error = curl_easy_strerror(rc);
+
+  curl_slist_free_all(headers);
+  release(slot);
+  return r;
+}
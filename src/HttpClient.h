@@ -0,0 +1,117 @@
+#pragma once
+
+#include "CancelToken.h"
+#include "SingleFlight.h"
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Başlık adları büyük/küçük harf duyarsız karşılaştırılır
+struct HttpHeaderLess {
+  bool operator()(const std::string &a, const std::string &b) const;
+};
+using HttpHeaders = std::map<std::string, std::string, HttpHeaderLess>;
+
+struct HttpResponse {
+  long status_code = 0; // 0: bağlantı/transfer hatası ya da iptal
+  std::string text;     // sink verildiyse boş
+  HttpHeaders header;   // Son (yönlendirme sonrası) yanıtın başlıkları
+  std::string error;
+};
+
+struct HttpOptions {
+  HttpHeaders headers;
+  // Sorgu parametreleri; URL-encode edilip URL'ye eklenir
+  std::vector<std::pair<std::string, std::string>> params;
+  // Gövde akışı: verilirse gövde belleğe alınmaz; false dönerse transfer
+  // kesilir (status_code 0)
+  std::function<bool(const char *data, size_t size)> sink;
+  // Kurulunca transfer (durmuş bağlantıda da) ~50 ms içinde kesilir
+  const CancelToken *cancel = nullptr;
+  // Toplam süre sınırı (ms); 0: yok, yalnızca bağlantı/durma sınırları
+  long timeoutMs = 0;
+  // Bellek içi GET'i disk önbelleğinden (setCacheDir) sun / doğrula
+  bool cache = false;
+  // Sertifika ve ana bilgisayar adı doğrulaması. Yalnızca sertifikası
+  // bilinen şekilde bozuk bir sunucu için, o istekte kapatılır.
+  bool verifyTls = true;
+};
+
+class HttpCache;
+
+// Süreç genelinde tek HTTP istemcisi. LauncherCore, DownloadManager,
+// ModManager ve AuthManager isteklerini buradan yapar: tek User-Agent,
+// tek zaman aşımı seti (bağlantı 15 sn, 30 sn veri gelmezse kes). TLS
+// sertifikaları her istekte doğrulanır (istek başına verifyTls ile kapanır).
+//
+// Bir libcurl share handle'ı DNS önbelleğini ve TLS oturumlarını tüm
+// handle'lar arasında paylaşır; bir yöneticinin çözdüğü ad ya da kurduğu
+// TLS oturumu diğerlerince yeniden kullanılır. Bağlantı önbelleği share'e
+// konmaz (libcurl eşzamanlı thread'ler arasında paylaşımını desteklemez):
+// senkron istekler boştaki (multi, easy) çiftleri havuzundan çalışır; multi
+// açık bağlantıları tuttuğundan aynı sunucuya giden ardışık istekler
+// bağlantıyı yeniden kullanır. Çağrı, iptali kısa aralıklarla denetleyen
+// bir curl_multi_poll döngüsünde yürür. DownloadManager'ın multi
+// handle'ları kendi bağlantı havuzlarını tutar, share'i configure ile alır.
+//
+// Aynı URL'ye (ve başlıklara) eşzamanlı bellek içi GET'ler tek uçuşta
+// birleşir: ör. iki yöneticinin aynı anda istediği meta veri bir kez
+// indirilir, yanıt hepsine döner.
+//
+// cache seçeneğiyle istenen meta veri (manifest, loader listeleri, Modrinth
+// sürüm listeleri) HttpCache'te saklanır: taze kayıt ağa çıkmadan döner,
+// bayat kayıt koşullu istekle doğrulanır (değişmediyse 304, gövdesiz).
+class HttpClient {
+public:
+  static HttpClient &instance();
+
+  HttpClient(const HttpClient &) = delete;
+  HttpClient &operator=(const HttpClient &) = delete;
+
+  static const char *userAgent();
+
+  // Meta veri önbelleğinin dizini (ör. <mcDir>/cache/http); boş: kapalı
+  void setCacheDir(const std::string &dir);
+
+  HttpResponse get(const std::string &url,
+                   const CancelToken *cancel = nullptr);
+  HttpResponse get(const std::string &url, const HttpOptions &opt);
+  HttpResponse head(const std::string &url, const HttpOptions &opt);
+  HttpResponse post(const std::string &url, const std::string &body,
+                    const HttpOptions &opt);
+
+  // Ortak ayarları (share, User-Agent, zaman aşımları, TLS) dışarıda
+  // yönetilen bir easy handle'a (CURL *) uygular
+  void configure(void *easy, bool verifyTls = true) const;
+
+private:
+  enum class Method { Get, Head, Post };
+  struct Share;
+  // Bağlantı havuzunu tutan multi + onun tek easy handle'ı (CURLM *, CURL *)
+  struct Slot {
+    void *multi = nullptr;
+    void *easy = nullptr;
+  };
+
+  HttpClient();
+  ~HttpClient();
+
+  HttpResponse perform(Method method, const std::string &url,
+                       const HttpOptions &opt, const std::string *body);
+  HttpResponse transfer(Method method, const std::string &url,
+                        const HttpOptions &opt, const std::string *body);
+  HttpResponse cachedGet(const std::string &url, const HttpOptions &opt);
+  Slot acquire();
+  void release(Slot slot);
+
+  std::unique_ptr<Share> m_share;
+  std::unique_ptr<HttpCache> m_cache;
+  std::mutex m_poolMtx;
+  std::vector<Slot> m_idle; // Bağlantılarını koruyan boştaki çiftler
+  SingleFlight<HttpResponse> m_gets;
+};
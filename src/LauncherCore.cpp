@@ -1,9 +1,14 @@
 #include "LauncherCore.h"
 #include "AuthManager.h"
+#include "BandwidthLimiter.h"
 #include "DownloadManager.h"
+#include "DurableCommit.h"
+#include "HttpClient.h"
+#include "Metrics.h"
+#include "MirrorTable.h"
 #include "ModManager.h"
+#include "ObjectStore.h"
 
-#include <cpr/cpr.h>
 #include <nlohmann/json.hpp>
 #include <spdlog/spdlog.h>
 
@@ -11,6 +16,9 @@
 #include <QProcess>
 #include <QStandardPaths>
 
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
@@ -18,52 +26,117 @@
 
 using json = nlohmann::json;
 namespace fs = std::filesystem;
-static const char *UA = "MixCrafter/2.0";
 
-// ══════════════════════════════════════════════════════════
-LauncherCore::LauncherCore(QObject *parent) : QObject(parent) {
+static double secondsSince(std::chrono::steady_clock::time_point t0) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0)
+      .count();
+}
+
+static QString defaultMcDir() {
 #ifdef Q_OS_WIN
-  m_mcDir = QDir::homePath() + "/AppData/Roaming/.minecraftmix";
+  return QDir::homePath() + "/AppData/Roaming/.minecraftmix";
 #else
-  m_mcDir = QDir::homePath() + "/.minecraftmix";
+  return QDir::homePath() + "/.minecraftmix";
 #endif
+}
+
+// ══════════════════════════════════════════════════════════
+LauncherCore::LauncherCore(QObject *parent)
+    : LauncherCore(defaultMcDir(), parent) {}
+
+LauncherCore::LauncherCore(const QString &mcDir, QObject *parent)
+    : QObject(parent), m_mcDir(mcDir) {
   QDir().mkpath(m_mcDir);
   QDir().mkpath(m_mcDir + "/versions");
   QDir().mkpath(m_mcDir + "/libraries");
   QDir().mkpath(m_mcDir + "/assets");
 
-  // Use a reasonable number of threads to avoid UI freezes
-  m_downloads = std::make_unique<DownloadManager>(12, this);
+  // Profiller arası paylaşılan içerik adresli depo
+  ObjectStore::instance().setRoot(m_mcDir.toStdString() + "/store");
+  // Manifest ve loader/mod meta verisi: ETag/Last-Modified ile doğrulanır
+  HttpClient::instance().setCacheDir(m_mcDir.toStdString() + "/cache/http");
+
+  // Up to 64 concurrent transfers multiplexed over a few event-loop
+  // threads; AIMD picks the live value for the current link
+  m_downloads = std::make_unique<DownloadManager>(64, this);
+  m_downloads->setHashIndexPath(m_mcDir.toStdString() +
+                                "/cache/hash-index.txt");
+  // MIXLAUNCHER_IO_URING=0: küçük dosyalar için io_uring yazıcısını kapat
+  const char *uring = std::getenv("MIXLAUNCHER_IO_URING");
+  if (uring && std::string(uring) == "0")
+    m_downloads->setIoUring(false);
+  // MIXLAUNCHER_MAX_RETRIES=N: geçici hatalarda görev başına deneme sınırı
+  if (const char *retries = std::getenv("MIXLAUNCHER_MAX_RETRIES"))
+    m_downloads->setMaxRetries(std::max(0, std::atoi(retries)));
+  // MIXLAUNCHER_DEEP_VERIFY=1: hash dizinine güvenme, her dosyayı hash'le
+  const char *deep = std::getenv("MIXLAUNCHER_DEEP_VERIFY");
+  if (deep && std::string(deep) == "1")
+    m_downloads->setDeepVerify(true);
+  // MIXLAUNCHER_CHUNK_MB=N[:S]: N MB ve üstü dosyaları en fazla S parçada
+  // indir (varsayılan S=4). N=0: parçalı indirme kapalı
+  if (const char *chunk = std::getenv("MIXLAUNCHER_CHUNK_MB")) {
+    char *rest = nullptr;
+    long long mb = std::strtoll(chunk, &rest, 10);
+    int segments = (rest && *rest == ':') ? std::atoi(rest + 1) : 4;
+    m_downloads->setChunking(std::max(0LL, mb) << 20, segments);
+  }
+  // İsteğe bağlı ayna tablosu; gecikmeler arka planda ölçülür
+  MirrorTable::instance().load(m_mcDir.toStdString() + "/mirrors.json");
+  MirrorTable::instance().probeAsync();
   m_mods = std::make_unique<ModManager>(m_mcDir, this);
   m_auth = std::make_unique<AuthManager>(m_mcDir, this);
 
-  // Wire download signals → our signals
-  connect(m_downloads.get(), &DownloadManager::progressUpdated, this,
-          &LauncherCore::installProgress);
-  connect(m_downloads.get(), &DownloadManager::allFinished, this,
-          [this](int ok, int fail) {
-            emit installFinished(
-                fail == 0, fail == 0
-                               ? "Kurulum tamamlandi!"
-                               : QString("%1 dosya indirilemedi").arg(fail));
-          });
-
   // Download authlib-injector on startup (async, non-blocking)
   m_auth->ensureAuthlibInjector();
 }
 
-LauncherCore::~LauncherCore() = default;
+LauncherCore::~LauncherCore() { cancel(); }
+
+void LauncherCore::cancel() {
+  {
+    std::lock_guard<std::mutex> lk(m_cancelMtx);
+    m_cancel.cancel();
+    m_cancel = CancelToken();
+  }
+  m_downloads->cancel();
+  m_mods->cancel();
+}
+
+CancelToken LauncherCore::token() const {
+  std::lock_guard<std::mutex> lk(m_cancelMtx);
+  return m_cancel;
+}
+
+bool LauncherCore::dumpMetrics(const QString &path) {
+  // Öncelik: parametre > MIXLAUNCHER_METRICS > <mcDir>/logs/metrics.json
+  std::string out = path.toStdString();
+  if (out.empty()) {
+    const char *env = std::getenv("MIXLAUNCHER_METRICS");
+    out = env && *env ? env : m_mcDir.toStdString() + "/logs/metrics.json";
+  }
+  return Metrics::instance().dump(out);
+}
 
 // ══════════════════════════════════════════════════════════
 //  Version Manifest
 // ══════════════════════════════════════════════════════════
 void LauncherCore::fetchVersionManifest() {
-  std::thread([this]() {
-    auto r = cpr::Get(
-        cpr::Url{
-            "https://piston-meta.mojang.com/mc/game/version_manifest_v2.json"},
-        cpr::Header{{"User-Agent", UA}}, cpr::Timeout{15000});
-
+  std::thread([this, cancel = token()]() {
+    auto t0 = std::chrono::steady_clock::now();
+    auto r = MirrorTable::instance().fetch(
+        "https://piston-meta.mojang.com/mc/game/version_manifest_v2.json",
+        [&cancel](const std::string &u) {
+          HttpOptions opt;
+          opt.cancel = &cancel;
+          opt.cache = true;
+          return HttpClient::instance().get(u, opt);
+        },
+        &cancel);
+
+    if (cancel.cancelled()) {
+      spdlog::info("Manifest istegi iptal edildi");
+      return;
+    }
     if (r.status_code != 200) {
       spdlog::error("Manifest alinamadi: HTTP {}", r.status_code);
       return;
@@ -88,6 +161,7 @@ void LauncherCore::fetchVersionManifest() {
         ids << QString::fromStdString(e.id);
     }
 
+    Metrics::instance().observePhase("manifest", secondsSince(t0));
     spdlog::info("Manifest: {} release surumu yuklendi", ids.size());
     emit versionsReady(ids);
   }).detach();
@@ -97,11 +171,23 @@ void LauncherCore::fetchVersionManifest() {
 //  Install Version  (full delta – libraries + assets + jar)
 // ══════════════════════════════════════════════════════════
 void LauncherCore::installVersion(const QString &versionId) {
-  std::thread([this, versionId]() { doInstall(versionId); }).detach();
+  std::thread([this, versionId, cancel = token()]() {
+    doInstall(versionId, cancel);
+  }).detach();
 }
 
-void LauncherCore::doInstall(const QString &versionId) {
+void LauncherCore::doInstall(const QString &versionId,
+                             const CancelToken &cancel) {
   std::string vid = versionId.toStdString();
+  auto installStart = std::chrono::steady_clock::now();
+
+  // Kuyruğa verilmeden biten her yol: "total" fazını kapat, metrikleri
+  // yaz, sonra bildir (kuyruktan sonra bunu job'un finished'ı yapar)
+  auto finish = [&](bool ok, const QString &msg) {
+    Metrics::instance().observePhase("total", secondsSince(installStart));
+    dumpMetrics();
+    emit installFinished(ok, msg);
+  };
 
   // 1. Find version url
   std::string vUrl;
@@ -122,40 +208,48 @@ void LauncherCore::doInstall(const QString &versionId) {
       auto jLocal = json::parse(ifs, nullptr, false);
       if (!jLocal.is_discarded() && jLocal.contains("inheritsFrom")) {
         std::string parent = jLocal["inheritsFrom"];
-        doInstall(QString::fromStdString(parent)); // install parent first
+        // install parent first
+        doInstall(QString::fromStdString(parent), cancel);
       }
-      emit installFinished(true, "Modlu surum hazir");
+      finish(true, "Modlu surum hazir");
       return;
     }
-    emit installFinished(false, "Surum bulunamadi: " + versionId);
+    finish(false, "Surum bulunamadi: " + versionId);
     return;
   }
 
   // 2. Download version JSON
   std::cout << "[INFO] Sürüm JSON indiriliyor: " << vUrl << std::endl;
-  auto vr = cpr::Get(cpr::Url{vUrl}, cpr::Header{{"User-Agent", UA}},
-                     cpr::VerifySsl{false});
+  auto phase = std::chrono::steady_clock::now();
+  auto vr = MirrorTable::instance().fetch(
+      vUrl,
+      [&cancel](const std::string &u) {
+        return HttpClient::instance().get(u, &cancel);
+      },
+      &cancel);
+  Metrics::instance().observePhase("version_json", secondsSince(phase));
+  if (cancel.cancelled()) {
+    finish(false, "Kurulum iptal edildi");
+    return;
+  }
   if (vr.status_code != 200) {
     std::cerr << "[HATA] Sürüm JSON indirilemedi: " << vr.status_code
               << std::endl;
-    emit installFinished(false, "Version JSON indirilemedi");
+    finish(false, "Version JSON indirilemedi");
     return;
   }
 
   auto vj = json::parse(vr.text, nullptr, false);
   if (vj.is_discarded()) {
     std::cerr << "[HATA] JSON parse hatası" << std::endl;
-    emit installFinished(false, "JSON parse hatasi");
+    finish(false, "JSON parse hatasi");
     return;
   }
 
   // Save version json
   std::string verDir = m_mcDir.toStdString() + "/versions/" + vid;
   fs::create_directories(verDir);
-  {
-    std::ofstream ofs(verDir + "/" + vid + ".json");
-    ofs << vj.dump(2);
-  }
+  DurableCommit::writeFile(verDir + "/" + vid + ".json", vj.dump(2));
 
   // 3. Build download queue
   std::vector<std::shared_ptr<DownloadTask>> tasks;
@@ -167,6 +261,7 @@ void LauncherCore::doInstall(const QString &versionId) {
     t->expectedSha1 = vj["downloads"]["client"].value("sha1", "");
     t->expectedSize = vj["downloads"]["client"].value("size", 0);
     t->destPath = verDir + "/" + vid + ".jar";
+    t->priority = DownloadPriority::Critical;
     tasks.push_back(t);
   }
 
@@ -204,6 +299,7 @@ void LauncherCore::doInstall(const QString &versionId) {
         t->expectedSize = art.value("size", 0);
         t->destPath =
             m_mcDir.toStdString() + "/libraries/" + art.value("path", "");
+        t->priority = DownloadPriority::Critical;
         if (!t->url.empty())
           tasks.push_back(t);
       }
@@ -216,20 +312,26 @@ void LauncherCore::doInstall(const QString &versionId) {
     auto t = std::make_shared<DownloadTask>();
     t->url = ai.value("url", "");
     t->expectedSha1 = ai.value("sha1", "");
+    t->expectedSize = ai.value("size", 0);
     std::string assetId = ai.value("id", "");
     t->destPath =
         m_mcDir.toStdString() + "/assets/indexes/" + assetId + ".json";
+    t->priority = DownloadPriority::AssetIndex;
     tasks.push_back(t);
 
     // Download the asset index to also queue individual assets
-    auto air = cpr::Get(cpr::Url{t->url}, cpr::Header{{"User-Agent", UA}});
+    phase = std::chrono::steady_clock::now();
+    auto air = MirrorTable::instance().fetch(
+        t->url,
+        [&cancel](const std::string &u) {
+          return HttpClient::instance().get(u, &cancel);
+        },
+        &cancel);
+    Metrics::instance().observePhase("asset_index", secondsSince(phase));
     if (air.status_code == 200) {
       // Save index
       fs::create_directories(fs::path(t->destPath).parent_path());
-      {
-        std::ofstream ofs(t->destPath);
-        ofs << air.text;
-      }
+      DurableCommit::writeFile(t->destPath, air.text);
 
       auto aj = json::parse(air.text, nullptr, false);
       if (!aj.is_discarded() && aj.contains("objects")) {
@@ -242,8 +344,10 @@ void LauncherCore::doInstall(const QString &versionId) {
           at->url =
               "https://resources.download.minecraft.net/" + prefix + "/" + hash;
           at->expectedSha1 = hash;
+          at->expectedSize = obj.value("size", 0);
           at->destPath =
               m_mcDir.toStdString() + "/assets/objects/" + prefix + "/" + hash;
+          at->priority = DownloadPriority::Asset;
           tasks.push_back(at);
         }
       }
@@ -254,9 +358,49 @@ void LauncherCore::doInstall(const QString &versionId) {
             << " dosya" << std::endl;
   spdlog::info("Indirme kuyruğu: {} dosya", tasks.size());
 
-  // 4. Feed to DownloadManager and start
-  m_downloads->enqueueBatch(std::move(tasks));
-  m_downloads->start();
+  Metrics::instance().observePhase("queue", secondsSince(installStart));
+
+  if (cancel.cancelled()) {
+    finish(false, "Kurulum iptal edildi");
+    return;
+  }
+
+  // 4. Plan: directories once, free-space check, preallocation
+  phase = std::chrono::steady_clock::now();
+  std::string planError;
+  if (!m_downloads->prepare(tasks, planError)) {
+    std::cerr << "[HATA] " << planError << std::endl;
+    spdlog::error("Kurulum plani basarisiz: {}", planError);
+    finish(false, QString::fromStdString(planError));
+    return;
+  }
+  Metrics::instance().observePhase("plan", secondsSince(phase));
+
+  // 5. Own download job on the shared pool; job signals → our signals
+  auto job = m_downloads->createJob();
+  connect(job.get(), &DownloadJob::progressUpdated, this,
+          &LauncherCore::installProgress);
+  connect(job.get(), &DownloadJob::byteProgress, this,
+          &LauncherCore::installBytes);
+  connect(job.get(), &DownloadJob::classpathReady, this,
+          &LauncherCore::installPlayable);
+  auto downloadStart = std::chrono::steady_clock::now();
+  connect(job.get(), &DownloadJob::finished, this,
+          [this, installStart, downloadStart](int ok, int fail) {
+            Metrics::instance().observePhase("download",
+                                             secondsSince(downloadStart));
+            Metrics::instance().observePhase("total",
+                                             secondsSince(installStart));
+            dumpMetrics();
+            emit installFinished(
+                fail == 0, fail == 0
+                               ? "Kurulum tamamlandi!"
+                               : QString("%1 dosya indirilemedi").arg(fail));
+          });
+  m_downloads->submit(job, tasks);
+  // submit ile cancel() arasında kalan pencere
+  if (cancel.cancelled())
+    job->cancel();
 }
 
 // ══════════════════════════════════════════════════════════
@@ -502,10 +646,21 @@ void LauncherCore::launchGame(const QString &versionId, int ramMb,
   auto *proc = new QProcess(this);
   connect(proc, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
           this, [this, proc](int code, QProcess::ExitStatus) {
+            BandwidthLimiter::instance().gameExited();
             emit gameClosed(code);
             proc->deleteLater();
           });
+  connect(proc, &QProcess::errorOccurred, this,
+          [proc](QProcess::ProcessError err) {
+            // Hiç başlamadıysa finished gelmez
+            if (err == QProcess::FailedToStart) {
+              BandwidthLimiter::instance().gameExited();
+              proc->deleteLater();
+            }
+          });
 
+  // Oyun açıkken arka plan indirmeleri bağlantıyı boğmasın
+  BandwidthLimiter::instance().gameStarted();
   proc->start("java", args);
   emit gameStarted();
 }
@@ -1,9 +1,13 @@
 #pragma once
 
+#include "CancelToken.h"
+#include "DownloadManager.h"
+
 #include <QObject>
 #include <QString>
 #include <QStringList>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 struct VersionEntry {
@@ -12,7 +16,6 @@ struct VersionEntry {
   std::string url;  // version-JSON url
 };
 
-class DownloadManager;
 class ModManager;
 class AuthManager;
 
@@ -21,6 +24,9 @@ class LauncherCore : public QObject {
 
 public:
   explicit LauncherCore(QObject *parent = nullptr);
+  // Varsayılan ~/.minecraftmix yerine verilen oyun dizinini kullan
+  // (benchmark, taşınabilir kurulum)
+  explicit LauncherCore(const QString &mcDir, QObject *parent = nullptr);
   ~LauncherCore() override;
 
   // Sub-systems (owned, exposed for UI wiring)
@@ -37,6 +43,10 @@ public:
   // ── Install → uses DownloadManager worker pool ───────
   void installVersion(const QString &versionId); // async – delta
 
+  // Manifest/sürüm meta verisi isteklerini, indirme işlerini ve mod
+  // işlemlerini keser. Sonraki istekler yeni bir token ile başlar.
+  void cancel();
+
   // ── Launch ───────────────────────────────────────────
   void launchGame(const QString &versionId, int ramMb,
                   const QString &profileName = "");
@@ -44,9 +54,19 @@ public:
   // ── Installed versions ───────────────────────────────
   QStringList installedVersionIds() const;
 
+  // ── Metrics ──────────────────────────────────────────
+  // İndirme/kurulum ölçümlerini yaz (.prom -> Prometheus, aksi JSON).
+  // path boşsa MIXLAUNCHER_METRICS ya da <mcDir>/logs/metrics.json.
+  // Her kurulumun sonunda otomatik çağrılır.
+  bool dumpMetrics(const QString &path = QString());
+
 signals:
   void versionsReady(QStringList ids);
   void installProgress(int done, int total, QString file);
+  // Bayt düzeyinde ilerleme, hız ve kalan süre
+  void installBytes(DownloadProgress progress);
+  // jar + kütüphaneler hazır; varlıklar hâlâ iniyor olabilir
+  void installPlayable();
   void installFinished(bool ok, QString msg);
   void gameStarted();
   void gameClosed(int exitCode);
@@ -60,6 +80,10 @@ private:
 
   std::vector<VersionEntry> m_versions;
 
+  CancelToken m_cancel;
+  mutable std::mutex m_cancelMtx;
+  CancelToken token() const;
+
   // helpers
-  void doInstall(const QString &versionId);
+  void doInstall(const QString &versionId, const CancelToken &cancel);
 };
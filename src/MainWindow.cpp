@@ -1,6 +1,7 @@
 #include "MainWindow.h"
 #include "AnimatedTabBar.h"
 #include "AuthManager.h"
+#include "BandwidthLimiter.h"
 #include "DownloadManager.h"
 #include "LauncherCore.h"
 #include "ModManager.h"
@@ -36,6 +37,8 @@
 
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
+
 MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent) {
   setWindowTitle(QString::fromUtf8("MixLauncher v2.0"));
   setAcceptDrops(true);
@@ -49,8 +52,10 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent) {
   // Sinyal Bağlantıları
   connect(m_core.get(), &LauncherCore::versionsReady, this,
           &MainWindow::onVersionsReady);
-  connect(m_core.get(), &LauncherCore::installProgress, this,
+  connect(m_core.get(), &LauncherCore::installBytes, this,
           &MainWindow::onInstallProgress);
+  connect(m_core.get(), &LauncherCore::installPlayable, this,
+          &MainWindow::onInstallPlayable);
   connect(m_core.get(), &LauncherCore::installFinished, this,
           &MainWindow::onInstallDone);
 
@@ -386,6 +391,24 @@ QWidget *MainWindow::buildSettingsPage() {
   hRam->addWidget(m_ramLabel);
   v->addWidget(gRam);
 
+  // 2b. İndirme Hızı (0 = sınırsız)
+  auto *gNet = new QGroupBox("İndirme Hızı Sınırı");
+  auto *hNet = new QHBoxLayout(gNet);
+  hNet->setContentsMargins(20, 20, 20, 20);
+  auto *netSlider = new QSlider(Qt::Horizontal);
+  netSlider->setRange(0, 100);
+  netSlider->setValue(0);
+  auto *netLabel = new QLabel("Sınırsız");
+  connect(netSlider, &QSlider::valueChanged, [netLabel](int mb) {
+    netLabel->setText(mb == 0 ? QString("Sınırsız")
+                              : QString("%1 MB/s").arg(mb));
+    BandwidthLimiter::instance().setRate(static_cast<long long>(mb) * 1024 *
+                                         1024);
+  });
+  hNet->addWidget(netSlider);
+  hNet->addWidget(netLabel);
+  v->addWidget(gNet);
+
   // 3. Arkaplan
   auto *gBg = new QGroupBox("Görünüm");
   auto *hBg = new QHBoxLayout(gBg);
@@ -507,6 +530,7 @@ void MainWindow::onInstallVersion() {
         QString("Sürüm İndiriliyor: %1 (%2)").arg(name, ver));
 
     // 1. Vanilla İndir
+    m_playable = false;
     m_core->installVersion(ver);
 
     // 2. Modloader (Sonraki aşamada, install bitince tetiklenmesi daha doğru
@@ -531,9 +555,28 @@ void MainWindow::onInstallVersion() {
   }
 }
 
-void MainWindow::onInstallProgress(int d, int t, QString f) {
-  if (t > 0) {
-    int pct = (d * 100) / t;
+// 1536 -> "1.5 KB"
+static QString humanBytes(double b) {
+  const char *units[] = {"B", "KB", "MB", "GB"};
+  int u = 0;
+  while (b >= 1024.0 && u < 3) {
+    b /= 1024.0;
+    ++u;
+  }
+  return QString("%1 %2").arg(b, 0, 'f', u == 0 ? 0 : 1).arg(units[u]);
+}
+
+void MainWindow::onInstallProgress(DownloadProgress p) {
+  // Boyutlar biliniyorsa çubuk bayta göre ilerler (25 MB jar ile 300 B'lık
+  // ses dosyası aynı ağırlıkta sayılmasın)
+  int pct = -1;
+  if (p.bytesPlanned > 0)
+    pct = static_cast<int>(
+        std::min<long long>(100, p.bytesDone() * 100 / p.bytesPlanned));
+  else if (p.filesTotal > 0)
+    pct = (p.filesDone * 100) / p.filesTotal;
+
+  if (pct >= 0) {
     m_progress->setValue(pct);
 
     // Buton Progress
@@ -549,12 +592,31 @@ void MainWindow::onInstallProgress(int d, int t, QString f) {
             .arg(stop + 0.001, 0, 'f', 2);
 
     m_launchBtn->setStyleSheet(style);
-    m_launchBtn->setText(QString("YÜKLENİYOR %1%").arg(pct));
+    m_launchBtn->setText(m_playable ? QString("OYNA (%1%)").arg(pct)
+                                    : QString("YÜKLENİYOR %1%").arg(pct));
   }
-  m_statusLabel->setText(QString("İndiriliyor: %1").arg(f));
+
+  QString status = QString("İndiriliyor: %1").arg(p.currentFile);
+  if (p.currentFileSize > 0)
+    status += QString(" (%1 / %2)")
+                  .arg(humanBytes(p.currentFileBytes))
+                  .arg(humanBytes(p.currentFileSize));
+  if (p.bytesPerSec > 0.0)
+    status += QString("  •  %1/sn").arg(humanBytes(p.bytesPerSec));
+  if (p.etaSec > 0.0)
+    status += QString("  •  ~%1 sn kaldı").arg(qRound(p.etaSec));
+  m_statusLabel->setText(status);
+}
+
+void MainWindow::onInstallPlayable() {
+  // Jar + kütüphaneler hazır: varlıklar inerken oyun başlatılabilir
+  m_playable = true;
+  m_launchBtn->setEnabled(true);
+  m_statusLabel->setText("Oynanabilir – varlıklar arka planda iniyor...");
 }
 
 void MainWindow::onInstallDone(bool ok, QString msg) {
+  m_playable = false;
   m_progress->setValue(ok ? 100 : 0);
   m_statusLabel->setText(ok ? "İşlem Tamamlandı." : "Hata: " + msg);
 
@@ -43,7 +43,8 @@ private slots:
 
   // Core Sinyalleri
   void onVersionsReady(QStringList ids);
-  void onInstallProgress(int done, int total, QString currentFile);
+  void onInstallProgress(DownloadProgress progress);
+  void onInstallPlayable();
   void onInstallDone(bool ok, QString errorMsg);
   void onLaunchClicked();
 
@@ -79,6 +80,7 @@ private:
   // Oyun Sayfası
   QComboBox *m_verCombo; // Sürüm Seçimi
   QPushButton *m_launchBtn;
+  bool m_playable = false; // Classpath hazır, varlıklar iniyor
 
   // Mağaza Sayfası
   QComboBox *m_storeVerCombo;  // Hedef Sürüm
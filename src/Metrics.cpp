@@ -0,0 +1,212 @@
+#include "Metrics.h"
+
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+using json = nlohmann::json;
+namespace fs = std::filesystem;
+
+// Gecikme kovaları (ms) ve aşama kovaları (sn)
+static const std::vector<double> kLatencyBoundsMs = {
+    1, 5, 10, 25, 50, 100, 250, 500, 1000, 2500, 5000, 10000};
+static const std::vector<double> kPhaseBoundsSec = {
+    0.1, 0.5, 1, 2, 5, 10, 30, 60, 120, 300, 600};
+
+static const char *kPrefix = "mixlauncher_";
+
+Metrics &Metrics::instance() {
+  static Metrics metrics;
+  return metrics;
+}
+
+void Metrics::Histogram::observe(const std::vector<double> &bounds,
+                                 double v) {
+  if (counts.empty())
+    counts.assign(bounds.size() + 1, 0);
+  size_t i = 0;
+  while (i < bounds.size() && v > bounds[i])
+    ++i;
+  counts[i]++;
+  count++;
+  sum += v;
+}
+
+void Metrics::add(const std::string &name, long long value,
+                  const std::string &label) {
+  std::string key = label.empty() ? name : name + "{" + label + "}";
+  std::lock_guard<std::mutex> lk(m_mtx);
+  m_counters[key] += value;
+}
+
+void Metrics::observeTransfer(const std::string &host, const Timing &t,
+                              long long bytes, bool ok) {
+  std::lock_guard<std::mutex> lk(m_mtx);
+  HostStats &h = m_hosts[host];
+  h.dns.observe(kLatencyBoundsMs, t.dnsMs);
+  h.connect.observe(kLatencyBoundsMs, t.connectMs);
+  h.tls.observe(kLatencyBoundsMs, t.tlsMs);
+  h.ttfb.observe(kLatencyBoundsMs, t.ttfbMs);
+  h.total.observe(kLatencyBoundsMs, t.totalMs);
+  h.bytes += bytes;
+  h.requests++;
+  if (!ok)
+    h.failures++;
+}
+
+void Metrics::observePhase(const std::string &phase, double seconds) {
+  std::lock_guard<std::mutex> lk(m_mtx);
+  m_phases[phase].observe(kPhaseBoundsSec, seconds);
+  m_lastPhase[phase] = seconds;
+}
+
+void Metrics::reset() {
+  std::lock_guard<std::mutex> lk(m_mtx);
+  m_counters.clear();
+  m_hosts.clear();
+  m_phases.clear();
+  m_lastPhase.clear();
+}
+
+// ── JSON ─────────────────────────────────────────────────
+static json histJson(const std::vector<long long> &counts, long long count,
+                     double sum, const std::vector<double> &bounds) {
+  json buckets = json::array();
+  long long cum = 0;
+  for (size_t i = 0; i < counts.size(); ++i) {
+    cum += counts[i];
+    buckets.push_back({i < bounds.size() ? json(bounds[i]) : json("+Inf"),
+                       cum});
+  }
+  return {{"count", count},
+          {"sum", sum},
+          {"avg", count ? sum / count : 0.0},
+          {"buckets", buckets}};
+}
+
+std::string Metrics::toJson() {
+  std::lock_guard<std::mutex> lk(m_mtx);
+  json j;
+  j["counters"] = m_counters;
+
+  json hosts = json::object();
+  for (auto &[name, h] : m_hosts) {
+    auto hj = [&](const Histogram &x) {
+      return histJson(x.counts, x.count, x.sum, kLatencyBoundsMs);
+    };
+    hosts[name] = {{"requests", h.requests},
+                   {"failures", h.failures},
+                   {"bytes", h.bytes},
+                   {"dns_ms", hj(h.dns)},
+                   {"connect_ms", hj(h.connect)},
+                   {"tls_ms", hj(h.tls)},
+                   {"ttfb_ms", hj(h.ttfb)},
+                   {"total_ms", hj(h.total)}};
+  }
+  j["hosts"] = hosts;
+
+  json phases = json::object();
+  for (auto &[name, h] : m_phases) {
+    phases[name] = histJson(h.counts, h.count, h.sum, kPhaseBoundsSec);
+    phases[name]["last"] = m_lastPhase[name];
+  }
+  j["install_phases_seconds"] = phases;
+  return j.dump(2);
+}
+
+// ── Prometheus text ──────────────────────────────────────
+static void promHist(std::ostringstream &os, const std::string &name,
+                     const std::string &labels, const std::vector<long long> &counts,
+                     long long count, double sum,
+                     const std::vector<double> &bounds) {
+  std::string sep = labels.empty() ? "" : ",";
+  long long cum = 0;
+  for (size_t i = 0; i < counts.size(); ++i) {
+    cum += counts[i];
+    os << name << "_bucket{" << labels << sep << "le=\"";
+    if (i < bounds.size())
+      os << bounds[i];
+    else
+      os << "+Inf";
+    os << "\"} " << cum << "\n";
+  }
+  std::string braces = labels.empty() ? "" : "{" + labels + "}";
+  os << name << "_sum" << braces << " " << sum << "\n";
+  os << name << "_count" << braces << " " << count << "\n";
+}
+
+std::string Metrics::toPrometheus() {
+  std::lock_guard<std::mutex> lk(m_mtx);
+  std::ostringstream os;
+
+  std::string lastName;
+  for (auto &[key, value] : m_counters) {
+    std::string name = key.substr(0, key.find('{'));
+    if (name != lastName) {
+      os << "# TYPE " << kPrefix << name << " counter\n";
+      lastName = name;
+    }
+    os << kPrefix << key << " " << value << "\n";
+  }
+
+  const std::pair<const char *, Histogram HostStats::*> hostHists[] = {
+      {"http_dns_ms", &HostStats::dns},
+      {"http_connect_ms", &HostStats::connect},
+      {"http_tls_ms", &HostStats::tls},
+      {"http_ttfb_ms", &HostStats::ttfb},
+      {"http_total_ms", &HostStats::total}};
+  for (auto &[suffix, member] : hostHists) {
+    std::string name = std::string(kPrefix) + suffix;
+    os << "# TYPE " << name << " histogram\n";
+    for (auto &[host, h] : m_hosts) {
+      const Histogram &x = h.*member;
+      promHist(os, name, "host=\"" + host + "\"", x.counts, x.count, x.sum,
+               kLatencyBoundsMs);
+    }
+  }
+
+  const std::pair<const char *, long long HostStats::*> hostCounters[] = {
+      {"http_requests_total", &HostStats::requests},
+      {"http_failures_total", &HostStats::failures},
+      {"http_bytes_total", &HostStats::bytes}};
+  for (auto &[suffix, member] : hostCounters) {
+    os << "# TYPE " << kPrefix << suffix << " counter\n";
+    for (auto &[host, h] : m_hosts)
+      os << kPrefix << suffix << "{host=\"" << host << "\"} " << h.*member
+         << "\n";
+  }
+
+  std::string phaseName = std::string(kPrefix) + "install_phase_seconds";
+  os << "# TYPE " << phaseName << " histogram\n";
+  for (auto &[phase, h] : m_phases)
+    promHist(os, phaseName, "phase=\"" + phase + "\"", h.counts, h.count,
+             h.sum, kPhaseBoundsSec);
+  return os.str();
+}
+
+bool Metrics::dump(const std::string &path) {
+  bool prom = fs::path(path).extension() == ".prom";
+  std::string body = prom ? toPrometheus() : toJson();
+
+  std::error_code ec;
+  fs::create_directories(fs::path(path).parent_path(), ec);
+  std::string tmp = path + ".tmp";
+  {
+    std::ofstream ofs(tmp, std::ios::binary | std::ios::trunc);
+    if (!ofs)
+      return false;
+    ofs << body;
+    if (!ofs)
+      return false;
+  }
+  fs::rename(tmp, path, ec);
+  if (ec) {
+    spdlog::error("Metrikler yazilamadi: {} ({})", path, ec.message());
+    return false;
+  }
+  spdlog::info("Metrikler yazildi: {}", path);
+  return true;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Süreç genelinde indirme/kurulum ölçümleri. Gözetimsiz çalışan
+// makinelerde yavaş kurulumları teşhis etmek için sayaçlar, host başına
+// gecikme histogramları ve kurulum aşaması süreleri tutulur; JSON ya da
+// Prometheus metin biçiminde dosyaya yazılır.
+class Metrics {
+public:
+  static Metrics &instance();
+
+  // Sayaç (ör. "download_retries_total"). label boş değilse
+  // name{label} ayrı bir seri olarak tutulur (ör. source="store").
+  void add(const std::string &name, long long value = 1,
+           const std::string &label = {});
+
+  // Tamamlanan bir HTTP transferinin libcurl zamanlamaları (ms)
+  struct Timing {
+    double dnsMs = 0.0;
+    double connectMs = 0.0;
+    double tlsMs = 0.0;
+    double ttfbMs = 0.0;
+    double totalMs = 0.0;
+  };
+  void observeTransfer(const std::string &host, const Timing &t,
+                       long long bytes, bool ok);
+
+  // Kurulum aşaması süresi (sn): manifest, version_json, asset_index,
+  // queue, plan, download, total
+  void observePhase(const std::string &phase, double seconds);
+
+  void reset();
+
+  std::string toJson();
+  std::string toPrometheus();
+  // Uzantı .prom ise Prometheus, değilse JSON. tmp + rename ile yazılır.
+  bool dump(const std::string &path);
+
+private:
+  Metrics() = default;
+
+  // Sabit kovalı histogram (ms ya da sn, kovaya göre)
+  struct Histogram {
+    std::vector<long long> counts; // bounds.size() + 1 (+Inf)
+    long long count = 0;
+    double sum = 0.0;
+    void observe(const std::vector<double> &bounds, double v);
+  };
+
+  struct HostStats {
+    Histogram dns, connect, tls, ttfb, total;
+    long long bytes = 0;
+    long long requests = 0;
+    long long failures = 0;
+  };
+
+  std::mutex m_mtx;
+  std::map<std::string, long long> m_counters; // "name" ya da "name{label}"
+  std::map<std::string, HostStats> m_hosts;
+  std::map<std::string, Histogram> m_phases;
+  std::map<std::string, double> m_lastPhase;
+};
@@ -0,0 +1,185 @@
+#include "MirrorTable.h"
+#include "HttpClient.h"
+
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <fstream>
+#include <thread>
+
+using json = nlohmann::json;
+
+MirrorTable &MirrorTable::instance() {
+  static MirrorTable inst;
+  return inst;
+}
+
+// mirrors.json:
+// { "https://resources.download.minecraft.net/": ["http://lan/assets/"], ... }
+bool MirrorTable::load(const std::string &jsonPath) {
+  std::ifstream ifs(jsonPath);
+  if (!ifs)
+    return false;
+  auto j = json::parse(ifs, nullptr, false);
+  if (j.is_discarded() || !j.is_object()) {
+    spdlog::warn("Ayna tablosu okunamadi: {}", jsonPath);
+    return false;
+  }
+  for (auto &[prefix, bases] : j.items()) {
+    if (!bases.is_array())
+      continue;
+    for (auto &b : bases)
+      if (b.is_string())
+        addMirror(prefix, b.get<std::string>());
+  }
+  std::lock_guard<std::mutex> lk(m_mtx);
+  spdlog::info("Ayna tablosu: {} onek", m_groups.size());
+  return true;
+}
+
+void MirrorTable::addMirror(const std::string &upstreamPrefix,
+                            const std::string &base) {
+  std::lock_guard<std::mutex> lk(m_mtx);
+  auto it = std::find_if(m_groups.begin(), m_groups.end(), [&](const Group &g) {
+    return g.prefix == upstreamPrefix;
+  });
+  if (it == m_groups.end()) {
+    Group g;
+    g.prefix = upstreamPrefix;
+    g.endpoints.push_back({upstreamPrefix});
+    m_groups.push_back(std::move(g));
+    it = m_groups.end() - 1;
+  }
+  // Ölçüm gelene kadar kullanıcının eklediği ayna upstream'den önce gelir
+  Endpoint e{base};
+  it->endpoints.insert(it->endpoints.end() - 1, e);
+}
+
+void MirrorTable::setMirrorsOnly(bool on) {
+  std::lock_guard<std::mutex> lk(m_mtx);
+  m_mirrorsOnly = on;
+}
+
+MirrorTable::Group *MirrorTable::groupFor(const std::string &url) {
+  Group *best = nullptr;
+  for (auto &g : m_groups)
+    if (url.compare(0, g.prefix.size(), g.prefix) == 0 &&
+        (!best || g.prefix.size() > best->prefix.size()))
+      best = &g;
+  return best;
+}
+
+MirrorTable::Endpoint *
+MirrorTable::endpointFor(const std::string &candidateUrl) {
+  Endpoint *best = nullptr;
+  for (auto &g : m_groups)
+    for (auto &e : g.endpoints)
+      if (candidateUrl.compare(0, e.base.size(), e.base) == 0 &&
+          (!best || e.base.size() > best->base.size()))
+        best = &e;
+  return best;
+}
+
+std::vector<std::string> MirrorTable::candidates(const std::string &url) {
+  std::lock_guard<std::mutex> lk(m_mtx);
+  Group *g = groupFor(url);
+  if (!g)
+    return {url};
+
+  // Sağlıklılar gecikmeye göre; düşmüş olanlar en sona (son çare)
+  auto now = Clock::now();
+  std::vector<const Endpoint *> order;
+  for (auto &e : g->endpoints)
+    order.push_back(&e);
+  if (m_mirrorsOnly)
+    order.pop_back(); // Son eleman upstream
+  auto rank = [now](const Endpoint *e) {
+    bool down = now < e->downUntil;
+    // Ölçülmeyenler ölçülenlerden sonra, kendi aralarında tablo sırasıyla
+    double lat = e->latencyMs < 0 ? 1e12 : e->latencyMs;
+    return std::make_pair(down, lat);
+  };
+  std::stable_sort(order.begin(), order.end(),
+                   [&](const Endpoint *a, const Endpoint *b) {
+                     return rank(a) < rank(b);
+                   });
+
+  std::string rest = url.substr(g->prefix.size());
+  std::vector<std::string> out;
+  for (auto *e : order)
+    out.push_back(e->base + rest);
+  return out;
+}
+
+void MirrorTable::reportSuccess(const std::string &candidateUrl) {
+  std::lock_guard<std::mutex> lk(m_mtx);
+  if (Endpoint *e = endpointFor(candidateUrl)) {
+    e->failures = 0;
+    e->downUntil = {};
+  }
+}
+
+void MirrorTable::reportFailure(const std::string &candidateUrl) {
+  std::lock_guard<std::mutex> lk(m_mtx);
+  Endpoint *e = endpointFor(candidateUrl);
+  if (!e)
+    return;
+  // Art arda 3 hatada uç nokta 60 sn boyunca sıralamada sona düşer
+  if (++e->failures >= 3) {
+    e->downUntil = Clock::now() + std::chrono::seconds(60);
+    e->failures = 0;
+    spdlog::warn("Ayna devre disi (60 sn): {}", e->base);
+  }
+}
+
+double MirrorTable::probeOne(const std::string &base) {
+  // Ortak istemci: aynı User-Agent, TLS doğrulaması ve DNS/TLS paylaşımı
+  HttpOptions opt;
+  opt.timeoutMs = 3000;
+  auto start = std::chrono::steady_clock::now();
+  auto r = HttpClient::instance().head(base, opt);
+  // Yanıt kodu önemsiz (kök dizin 404 olabilir); bağlantı + ilk yanıt süresi
+  if (r.status_code == 0)
+    return -1.0;
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+void MirrorTable::probeAsync() {
+  std::vector<std::string> bases;
+  {
+    std::lock_guard<std::mutex> lk(m_mtx);
+    if (m_mirrorsOnly)
+      return;
+    for (auto &g : m_groups)
+      for (auto &e : g.endpoints)
+        bases.push_back(e.base);
+  }
+  if (bases.empty())
+    return;
+
+  std::thread([this, bases]() {
+    std::vector<std::thread> probes;
+    std::vector<double> results(bases.size(), -1.0);
+    for (size_t i = 0; i < bases.size(); ++i)
+      probes.emplace_back([&, i] { results[i] = probeOne(bases[i]); });
+    for (auto &p : probes)
+      p.join();
+
+    std::lock_guard<std::mutex> lk(m_mtx);
+    for (size_t i = 0; i < bases.size(); ++i) {
+      for (auto &g : m_groups)
+        for (auto &e : g.endpoints)
+          if (e.base == bases[i]) {
+            if (results[i] < 0) {
+              e.downUntil = Clock::now() + std::chrono::seconds(60);
+            } else {
+              e.latencyMs = results[i];
+            }
+          }
+      spdlog::info("Ayna gecikmesi: {} -> {:.1f} ms", bases[i], results[i]);
+    }
+  }).detach();
+}
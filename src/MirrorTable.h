@@ -0,0 +1,83 @@
+#pragma once
+
+#include "CancelToken.h"
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Upstream URL önekleri için ayna (mirror/CDN) tablosu.
+//   "https://resources.download.minecraft.net/" -> ["http://lan:8080/assets/"]
+// Her önek için upstream + aynalar gecikmeye göre sıralanır; bir görev
+// başarısız olursa sıradaki sağlıklı adaya geçilir. Tablo
+// <mcDir>/mirrors.json'dan okunur; dosya yoksa her URL olduğu gibi kullanılır.
+class MirrorTable {
+public:
+  static MirrorTable &instance();
+
+  bool load(const std::string &jsonPath);
+  void addMirror(const std::string &upstreamPrefix, const std::string &base);
+
+  // Yalnızca tablodaki aynalar: upstream aday olmaz, gecikme ölçülmez ve
+  // sıra tablo sırasıdır (ör. benchmark'ın çevrimdışı, tekrarlanabilir
+  // koşuları için). probeAsync'ten önce ayarlanmalı.
+  void setMirrorsOnly(bool on);
+
+  // Tüm uç noktaların gecikmesini arka planda ölç
+  void probeAsync();
+
+  // url için denenecek tam URL'ler, en iyi aday önce
+  std::vector<std::string> candidates(const std::string &url);
+
+  void reportSuccess(const std::string &candidateUrl);
+  void reportFailure(const std::string &candidateUrl);
+
+  // Adayları sırayla dener; ilk 200 yanıtını (ya da sonuncuyu) döndürür.
+  // fetch: std::string url -> status_code alanı olan yanıt. cancel
+  // kurulduysa sıradaki adaya geçilmez ve iptal ayna hatası sayılmaz.
+  template <class Fetch>
+  auto fetch(const std::string &url, Fetch &&fetch,
+             const CancelToken *cancel = nullptr) {
+    auto cands = candidates(url);
+    auto r = fetch(cands.front());
+    for (size_t i = 0;; ++i) {
+      if (r.status_code == 200) {
+        reportSuccess(cands[i]);
+        return r;
+      }
+      if (cancel && cancel->cancelled())
+        return r;
+      reportFailure(cands[i]);
+      if (i + 1 >= cands.size())
+        return r;
+      r = fetch(cands[i + 1]);
+    }
+  }
+
+private:
+  MirrorTable() = default;
+
+  using Clock = std::chrono::steady_clock;
+
+  struct Endpoint {
+    std::string base;
+    double latencyMs = -1.0; // <0: henüz ölçülmedi
+    int failures = 0;
+    Clock::time_point downUntil{};
+  };
+
+  struct Group {
+    std::string prefix; // upstream öneki
+    std::vector<Endpoint> endpoints; // son eleman upstream'in kendisi
+  };
+
+  Group *groupFor(const std::string &url);
+  Endpoint *endpointFor(const std::string &candidateUrl);
+  static double probeOne(const std::string &base);
+
+  std::mutex m_mtx;
+  std::vector<Group> m_groups;
+  bool m_mirrorsOnly = false;
+};
@@ -1,6 +1,12 @@
 #include "ModManager.h"
+#include "BandwidthLimiter.h"
+#include "DurableCommit.h"
+#include "FileSink.h"
+#include "HttpClient.h"
+#include "MirrorTable.h"
+#include "ObjectStore.h"
+#include "SingleFlight.h"
 
-#include <cpr/cpr.h>
 #include <nlohmann/json.hpp>
 #include <spdlog/spdlog.h>
 
@@ -10,10 +16,16 @@
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QProcess>
+#include <QSaveFile>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <filesystem>
 #include <fstream>
 #include <thread>
+#include <unordered_set>
+#include <vector>
 
 using json = nlohmann::json;
 namespace fs = std::filesystem;
@@ -21,7 +33,157 @@ namespace fs = std::filesystem;
 static const char *MODRINTH = "https://api.modrinth.com/v2";
 static const char *FABRIC_META = "https://meta.fabricmc.net/v2";
 static const char *QUILT_META = "https://meta.quiltmc.org/v3";
-static const char *UA = "MixCrafter/2.0 (contact@minecraftmix)";
+
+// Bu boyutun üstündeki dosyalar paralel Range parçalarıyla indirilir
+static constexpr long long kChunkThreshold = 8LL << 20;
+static constexpr long long kMinChunkBytes = 4LL << 20;
+static constexpr int kMaxChunks = 4;
+
+// size bayt, önceden ayrılmış dest'e paralel aralıklarla. Sunucu Range'i
+// yok sayarsa (tüm gövdeyi gönderir) false döner ve çağıran tek akışa
+// geçer; aksi halde out.status_code 200 ya da hatalı parçanın kodudur.
+static bool downloadRanges(const std::string &url, const std::string &dest,
+                           long long size, const CancelToken &cancel,
+                           HttpResponse &out) {
+  RangeSink sink;
+  if (!sink.open(dest, size))
+    return false;
+
+  int segments = static_cast<int>(
+      std::clamp<long long>(size / kMinChunkBytes, 2, kMaxChunks));
+  long long step = (size + segments - 1) / segments;
+  std::atomic<bool> ignored{false};
+  std::vector<HttpResponse> results(segments);
+  std::vector<std::thread> workers;
+  for (int i = 0; i < segments; ++i) {
+    long long from = i * step;
+    long long to = std::min(size, from + step) - 1;
+    workers.emplace_back([&, i, from, to] {
+      long long pos = from;
+      HttpOptions opt;
+      opt.headers = {{"Range", "bytes=" + std::to_string(from) + "-" +
+                                   std::to_string(to)}};
+      opt.cancel = &cancel;
+      opt.sink = [&](const char *data, size_t size) {
+        auto n = static_cast<long long>(size);
+        // Aralıktan fazlası geliyorsa sunucu Range'i yok saymıştır
+        if (ignored.load() || pos + n > to + 1) {
+          ignored = true;
+          return false;
+        }
+        BandwidthLimiter::instance().acquire(size, cancel.flag());
+        if (!sink.writeAt(pos, data, size))
+          return false;
+        pos += n;
+        return true;
+      };
+      results[i] = HttpClient::instance().get(url, opt);
+      if (results[i].status_code == 206 && pos != to + 1)
+        results[i].status_code = 0; // Eksik gövde
+    });
+  }
+  for (auto &w : workers)
+    w.join();
+  sink.close();
+
+  if (ignored.load() ||
+      std::any_of(results.begin(), results.end(),
+                  [](const HttpResponse &r) { return r.status_code == 200; }))
+    return false;
+  out = results.front();
+  out.status_code = 200;
+  for (auto &r : results)
+    if (r.status_code != 206) {
+      out = r;
+      break;
+    }
+  return true;
+}
+
+// Boyutu bilinmeyen büyük dosyalar için: sunucu aralık destekliyorsa
+// Content-Length, değilse 0
+static long long probeSize(const std::string &url, const CancelToken &cancel) {
+  HttpOptions opt;
+  opt.cancel = &cancel;
+  auto r = HttpClient::instance().head(url, opt);
+  if (r.status_code != 200 || r.header["Accept-Ranges"] != "bytes")
+    return 0;
+  try {
+    return std::stoll(r.header["Content-Length"]);
+  } catch (...) {
+    return 0;
+  }
+}
+
+// Dosyayı belleğe almadan, global hız sınırına uyarak <dest>.part'a yazar;
+// başarıda (ve sha1 verildiyse doğrulanınca) fsync + rename ile yerine
+// taşır, aksi halde yarım dosya silinir. HTTP durum kodunu döndürür
+// (hash tutmaz ya da taşınamazsa 0).
+// Ayna tanımlıysa adaylar sırayla denenir, her denemede dosya baştan yazılır.
+// size biliniyorsa ve eşiğin üstündeyse parçalı indirilir. cancel
+// kurulunca transfer kesilir ve yarım dosya silinir.
+static long fetchToFile(const std::string &url, const std::string &dest,
+                        const CancelToken &cancel, long long size,
+                        const std::string &sha1) {
+  std::string part = dest + ".part";
+  auto r = MirrorTable::instance().fetch(
+      url,
+      [&](const std::string &u) {
+        HttpResponse ranged;
+        if (size >= kChunkThreshold &&
+            downloadRanges(u, part, size, cancel, ranged))
+          return ranged;
+        std::ofstream ofs(part, std::ios::binary | std::ios::trunc);
+        if (!ofs)
+          return HttpResponse{};
+        HttpOptions opt;
+        opt.cancel = &cancel;
+        opt.sink = [&](const char *data, size_t n) {
+          BandwidthLimiter::instance().acquire(n, cancel.flag());
+          ofs.write(data, static_cast<std::streamsize>(n));
+          return static_cast<bool>(ofs);
+        };
+        return HttpClient::instance().get(u, opt);
+      },
+      &cancel);
+  std::error_code ec;
+  if (r.status_code != 200) {
+    fs::remove(part, ec);
+    return r.status_code;
+  }
+  if (!sha1.empty() && ObjectStore::sha1File(part) != sha1) {
+    spdlog::error("Hash tutmadi: {}", dest);
+    fs::remove(part, ec);
+    return 0;
+  }
+  return DurableCommit::commitFile(part, dest) ? 200 : 0;
+}
+
+// Aynı hedefe eşzamanlı indirmeler (ör. iki modun ortak bağımlılığı) tek
+// transferde birleşir: iki thread aynı .part'a yazmaz, bekleyen liderin
+// durum kodunu alır.
+static long downloadToFile(const std::string &url, const std::string &dest,
+                           const CancelToken &cancel, long long size = 0,
+                           const std::string &sha1 = {}) {
+  static SingleFlight<long> flights;
+  return flights.run(
+      dest, [&] { return fetchToFile(url, dest, cancel, size, sha1); },
+      &cancel);
+}
+
+// Loader/promotions meta verisi: aynalar üzerinden, disk önbellekli GET
+static HttpResponse metaGet(const std::string &url,
+                            const CancelToken &cancel) {
+  return MirrorTable::instance().fetch(
+      url,
+      [&cancel](const std::string &u) {
+        HttpOptions opt;
+        opt.cancel = &cancel;
+        opt.cache = true;
+        return HttpClient::instance().get(u, opt);
+      },
+      &cancel);
+}
 
 // ══════════════════════════════════════════════════════════
 ModManager::ModManager(const QString &mcDir, QObject *parent)
@@ -29,6 +191,19 @@ ModManager::ModManager(const QString &mcDir, QObject *parent)
   loadProfiles();
 }
 
+ModManager::~ModManager() { cancel(); }
+
+void ModManager::cancel() {
+  std::lock_guard<std::mutex> lk(m_cancelMtx);
+  m_cancel.cancel();
+  m_cancel = CancelToken();
+}
+
+CancelToken ModManager::token() const {
+  std::lock_guard<std::mutex> lk(m_cancelMtx);
+  return m_cancel;
+}
+
 // ══════════════════════════════════════════════════════════
 //  Profile persistence  (JSON in mcDir/profiles.json)
 // ══════════════════════════════════════════════════════════
@@ -59,9 +234,12 @@ void ModManager::saveProfiles() {
     o["modsPath"] = p.modsPath;
     arr.append(o);
   }
-  QFile f(m_mcDir + "/profiles.json");
-  if (f.open(QIODevice::WriteOnly))
+  // QSaveFile: geçici dosyaya yazar, commit'te fsync + rename
+  QSaveFile f(m_mcDir + "/profiles.json");
+  if (f.open(QIODevice::WriteOnly)) {
     f.write(QJsonDocument(arr).toJson());
+    f.commit();
+  }
 }
 
 void ModManager::createProfile(const QString &name, const QString &gameVer,
@@ -107,7 +285,7 @@ void ModManager::searchMods(const QString &query, const QString &loader,
   std::string v = gameVersion.toStdString();
   std::string pt = projectType.toStdString();
 
-  std::thread([this, q, l, v, pt]() {
+  std::thread([this, q, l, v, pt, cancel = token()]() {
     std::string facets =
         "[[\"versions:" + v + "\"],[\"project_type:" + pt + "\"]";
     if (pt == "mod" && !l.empty() && l != "yok (vanilla)" && l != "vanilla" &&
@@ -116,10 +294,13 @@ void ModManager::searchMods(const QString &query, const QString &loader,
     }
     facets += "]";
 
-    auto r = cpr::Get(
-        cpr::Url{std::string(MODRINTH) + "/search"},
-        cpr::Parameters{{"query", q}, {"facets", facets}, {"limit", "30"}},
-        cpr::Header{{"User-Agent", UA}}, cpr::VerifySsl{false});
+    HttpOptions opt;
+    opt.params = {{"query", q}, {"facets", facets}, {"limit", "30"}};
+    opt.cancel = &cancel;
+    auto r =
+        HttpClient::instance().get(std::string(MODRINTH) + "/search", opt);
+    if (cancel.cancelled())
+      return;
 
     QVector<ModSearchResult> results;
     if (r.status_code == 200) {
@@ -150,27 +331,37 @@ void ModManager::installMod(const QString &projectId, const QString &loader,
                             const QString &gameVersion,
                             const QString &profileName) {
   QString modsDir = profileModsPath(profileName);
-  std::thread([this, projectId, loader, gameVersion, modsDir]() {
-    resolveAndInstall(projectId, loader, gameVersion, modsDir);
+  std::thread([this, projectId, loader, gameVersion, modsDir,
+               cancel = token()]() {
+    std::unordered_set<std::string> seen;
+    resolveAndInstall(projectId, loader, gameVersion, modsDir, cancel, seen);
   }).detach();
 }
 
 void ModManager::resolveAndInstall(const QString &projectId,
                                    const QString &loader,
                                    const QString &gameVersion,
-                                   const QString &modsPath) {
+                                   const QString &modsPath,
+                                   const CancelToken &cancel,
+                                   std::unordered_set<std::string> &seen) {
   std::string pid = projectId.toStdString();
   std::string l = loader.toStdString();
   std::string gv = gameVersion.toStdString();
 
-  // 1.  Get compatible version of this mod
-  auto r =
-      cpr::Get(cpr::Url{std::string(MODRINTH) + "/project/" + pid + "/version"},
-               cpr::Parameters{{"loaders", "[\"" + l + "\"]"},
-                               {"game_versions", "[\"" + gv + "\"]"}},
-               cpr::Header{{"User-Agent", UA}}, cpr::VerifySsl{false});
+  // Ortak bağımlılık (ya da döngü) bu kurulumda zaten çözüldü
+  if (!seen.insert(pid).second)
+    return;
 
-  if (r.status_code != 200) {
+  // 1.  Get compatible version of this mod
+  HttpOptions opt;
+  opt.params = {{"loaders", "[\"" + l + "\"]"},
+                {"game_versions", "[\"" + gv + "\"]"}};
+  opt.cancel = &cancel;
+  opt.cache = true;
+  auto r = HttpClient::instance().get(
+      std::string(MODRINTH) + "/project/" + pid + "/version", opt);
+
+  if (r.status_code != 200 || cancel.cancelled()) {
     emit modInstalled(projectId, false);
     return;
   }
@@ -206,7 +397,10 @@ void ModManager::resolveAndInstall(const QString &projectId,
 
     // Auto-install required dependencies
     for (auto &dep : deps) {
-      resolveAndInstall(dep.projectId, loader, gameVersion, modsPath);
+      if (cancel.cancelled())
+        break;
+      resolveAndInstall(dep.projectId, loader, gameVersion, modsPath, cancel,
+                        seen);
     }
   }
 
@@ -215,8 +409,13 @@ void ModManager::resolveAndInstall(const QString &projectId,
     emit modInstalled(projectId, false);
     return;
   }
-  std::string fileUrl = ver["files"][0]["url"];
-  std::string fileName = ver["files"][0]["filename"];
+  auto &file = ver["files"][0];
+  std::string fileUrl = file["url"];
+  std::string fileName = file["filename"];
+  std::string sha1 = file.contains("hashes")
+                         ? file["hashes"].value("sha1", std::string())
+                         : std::string();
+  long long size = file.value("size", 0LL);
 
   fs::create_directories(modsPath.toStdString());
   std::string dest = modsPath.toStdString() + "/" + fileName;
@@ -228,16 +427,22 @@ void ModManager::resolveAndInstall(const QString &projectId,
     return;
   }
 
-  auto dr = cpr::Get(cpr::Url{fileUrl}, cpr::Header{{"User-Agent", UA}},
-                     cpr::Timeout{60000}, cpr::VerifySsl{false});
-  if (dr.status_code == 200) {
-    std::ofstream ofs(dest, std::ios::binary);
-    ofs.write(dr.text.data(), static_cast<std::streamsize>(dr.text.size()));
-    spdlog::info("Mod yuklendi: {}", fileName);
+  // Başka bir profil aynı jar'ı zaten indirdiyse depodan bağla
+  auto &store = ObjectStore::instance();
+  if (!sha1.empty() && store.contains(sha1) && store.materialize(sha1, dest)) {
+    spdlog::info("Mod depodan baglandi: {}", fileName);
     emit modInstalled(QString::fromStdString(fileName), true);
-  } else {
+    return;
+  }
+
+  if (downloadToFile(fileUrl, dest, cancel, size, sha1) != 200) {
     emit modInstalled(QString::fromStdString(fileName), false);
+    return;
   }
+  if (!sha1.empty())
+    store.adopt(dest, sha1);
+  spdlog::info("Mod yuklendi: {}", fileName);
+  emit modInstalled(QString::fromStdString(fileName), true);
 }
 
 // ══════════════════════════════════════════════════════════
@@ -245,11 +450,10 @@ void ModManager::resolveAndInstall(const QString &projectId,
 // ══════════════════════════════════════════════════════════
 void ModManager::installFabric(const QString &gameVersion) {
   std::string gv = gameVersion.toStdString();
-  std::thread([this, gv]() {
+  std::thread([this, gv, cancel = token()]() {
     // 1. Get latest loader version
     auto lr =
-        cpr::Get(cpr::Url{std::string(FABRIC_META) + "/versions/loader/" + gv},
-                 cpr::Header{{"User-Agent", UA}}, cpr::VerifySsl{false});
+        metaGet(std::string(FABRIC_META) + "/versions/loader/" + gv, cancel);
 
     if (lr.status_code != 200 || lr.text.empty()) {
       emit loaderInstalled("Fabric", "", false);
@@ -267,8 +471,7 @@ void ModManager::installFabric(const QString &gameVersion) {
     // 2. Get profile JSON
     std::string profileUrl = std::string(FABRIC_META) + "/versions/loader/" +
                              gv + "/" + loaderVer + "/profile/json";
-    auto pr = cpr::Get(cpr::Url{profileUrl}, cpr::Header{{"User-Agent", UA}},
-                       cpr::VerifySsl{false});
+    auto pr = metaGet(profileUrl, cancel);
 
     if (pr.status_code != 200) {
       emit loaderInstalled("Fabric", "", false);
@@ -282,13 +485,16 @@ void ModManager::installFabric(const QString &gameVersion) {
     // 3. Write to versions/<id>/<id>.json
     std::string verDir = m_mcDir.toStdString() + "/versions/" + verId;
     fs::create_directories(verDir);
-    std::ofstream ofs(verDir + "/" + verId + ".json");
-    ofs << profile.dump(2);
-    ofs.close();
+    DurableCommit::writeFile(verDir + "/" + verId + ".json", profile.dump(2));
 
     // 4. Download Fabric libraries (Maven jars)
     if (profile.contains("libraries")) {
       for (auto &lib : profile["libraries"]) {
+        if (cancel.cancelled()) {
+          spdlog::info("Fabric kurulumu iptal edildi");
+          emit loaderInstalled("Fabric", "", false);
+          return;
+        }
         if (!lib.contains("name"))
           continue;
         std::string mavenName = lib["name"].get<std::string>();
@@ -331,17 +537,12 @@ void ModManager::installFabric(const QString &gameVersion) {
         spdlog::info("Fabric lib indiriliyor: {}", downloadUrl);
         fs::create_directories(fs::path(destPath).parent_path());
 
-        auto dr =
-            cpr::Get(cpr::Url{downloadUrl}, cpr::Header{{"User-Agent", UA}},
-                     cpr::Timeout{60000}, cpr::VerifySsl{false});
-        if (dr.status_code == 200) {
-          std::ofstream libOfs(destPath, std::ios::binary);
-          libOfs.write(dr.text.data(),
-                       static_cast<std::streamsize>(dr.text.size()));
+        long status = downloadToFile(downloadUrl, destPath, cancel);
+        if (status == 200) {
           spdlog::info("Fabric lib yuklendi: {}", artifact);
         } else {
           spdlog::warn("Fabric lib indirilemedi: {} (HTTP {})", artifact,
-                       dr.status_code);
+                       status);
         }
       }
     }
@@ -356,10 +557,9 @@ void ModManager::installFabric(const QString &gameVersion) {
 // ══════════════════════════════════════════════════════════
 void ModManager::installQuilt(const QString &gameVersion) {
   std::string gv = gameVersion.toStdString();
-  std::thread([this, gv]() {
+  std::thread([this, gv, cancel = token()]() {
     auto lr =
-        cpr::Get(cpr::Url{std::string(QUILT_META) + "/versions/loader/" + gv},
-                 cpr::Header{{"User-Agent", UA}}, cpr::VerifySsl{false});
+        metaGet(std::string(QUILT_META) + "/versions/loader/" + gv, cancel);
 
     if (lr.status_code != 200) {
       emit loaderInstalled("Quilt", "", false);
@@ -375,8 +575,7 @@ void ModManager::installQuilt(const QString &gameVersion) {
     std::string loaderVer = loaders[0]["loader"]["version"];
     std::string profileUrl = std::string(QUILT_META) + "/versions/loader/" +
                              gv + "/" + loaderVer + "/profile/json";
-    auto pr = cpr::Get(cpr::Url{profileUrl}, cpr::Header{{"User-Agent", UA}},
-                       cpr::VerifySsl{false});
+    auto pr = metaGet(profileUrl, cancel);
 
     if (pr.status_code != 200) {
       emit loaderInstalled("Quilt", "", false);
@@ -389,8 +588,7 @@ void ModManager::installQuilt(const QString &gameVersion) {
 
     std::string verDir = m_mcDir.toStdString() + "/versions/" + verId;
     fs::create_directories(verDir);
-    std::ofstream ofs(verDir + "/" + verId + ".json");
-    ofs << profile.dump(2);
+    DurableCommit::writeFile(verDir + "/" + verId + ".json", profile.dump(2));
 
     spdlog::info("Quilt kuruldu: {}", verId);
     emit loaderInstalled("Quilt", QString::fromStdString(verId), true);
@@ -402,11 +600,11 @@ void ModManager::installQuilt(const QString &gameVersion) {
 // ══════════════════════════════════════════════════════════
 void ModManager::installForge(const QString &gameVersion) {
   std::string gv = gameVersion.toStdString();
-  std::thread([this, gv]() {
+  std::thread([this, gv, cancel = token()]() {
     // 1. Find forge version via promotions
-    auto pr = cpr::Get(cpr::Url{"https://files.minecraftforge.net/net/"
-                                "minecraftforge/forge/promotions_slim.json"},
-                       cpr::Header{{"User-Agent", UA}}, cpr::VerifySsl{false});
+    auto pr = metaGet("https://files.minecraftforge.net/net/"
+                      "minecraftforge/forge/promotions_slim.json",
+                      cancel);
 
     if (pr.status_code != 200) {
       emit loaderInstalled("Forge", "", false);
@@ -439,27 +637,33 @@ void ModManager::installForge(const QString &gameVersion) {
         "/forge-" + fullVer + "-installer.jar";
 
     std::string installerPath = m_mcDir.toStdString() + "/forge-installer.jar";
-    auto dr = cpr::Get(cpr::Url{installerUrl}, cpr::Header{{"User-Agent", UA}},
-                       cpr::Timeout{120000}, cpr::VerifySsl{false});
-
-    if (dr.status_code != 200) {
-      spdlog::error("Forge installer indirilemedi: HTTP {}", dr.status_code);
+    long status = downloadToFile(installerUrl, installerPath, cancel,
+                                 probeSize(installerUrl, cancel));
+    if (status != 200) {
+      spdlog::error("Forge installer indirilemedi: HTTP {}", status);
       emit loaderInstalled("Forge", "", false);
       return;
     }
 
-    std::ofstream ofs(installerPath, std::ios::binary);
-    ofs.write(dr.text.data(), static_cast<std::streamsize>(dr.text.size()));
-    ofs.close();
-
     // 3. Run installer headless
     QProcess proc;
     proc.setWorkingDirectory(QString::fromStdString(m_mcDir.toStdString()));
     proc.start("java", {"-jar", QString::fromStdString(installerPath),
                         "--installClient", m_mcDir});
-    proc.waitForFinished(300000); // 5 min timeout
+    // 5 min timeout; iptalde installer öldürülür
+    auto deadline =
+        std::chrono::steady_clock::now() + std::chrono::minutes(5);
+    while (!proc.waitForFinished(100)) {
+      if (proc.state() == QProcess::NotRunning)
+        break;
+      if (cancel.cancelled() || std::chrono::steady_clock::now() > deadline) {
+        proc.kill();
+        proc.waitForFinished(1000);
+        break;
+      }
+    }
 
-    bool ok = (proc.exitCode() == 0);
+    bool ok = proc.exitStatus() == QProcess::NormalExit && proc.exitCode() == 0;
     if (ok) {
       spdlog::info("Forge kuruldu: {}", fullVer);
       fs::remove(installerPath); // cleanup
@@ -1,9 +1,14 @@
 #pragma once
 
+#include "CancelToken.h"
+
 #include <QObject>
 #include <QString>
 #include <QVector>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
 
 // ── Data structures ──────────────────────────────────────
 struct ModSearchResult {
@@ -36,6 +41,11 @@ class ModManager : public QObject {
 
 public:
   explicit ModManager(const QString &mcDir, QObject *parent = nullptr);
+  ~ModManager() override;
+
+  // Süren arama/kurulum indirmelerini keser (yarım dosyalar silinir);
+  // sonraki işlemler yeni bir token ile başlar
+  void cancel();
 
   // ── Search ───────────────────────────────────────────
   void searchMods(const QString &query, const QString &loader,
@@ -67,10 +77,16 @@ signals:
 
 private:
   void resolveAndInstall(const QString &projectId, const QString &loader,
-                         const QString &gameVersion, const QString &modsPath);
+                         const QString &gameVersion, const QString &modsPath,
+                         const CancelToken &cancel,
+                         std::unordered_set<std::string> &seen);
+  // Yeni başlayan işlemin bağlanacağı token
+  CancelToken token() const;
 
   QString m_mcDir;
   QVector<ModProfile> m_profiles;
+  CancelToken m_cancel;
+  mutable std::mutex m_cancelMtx;
   void loadProfiles();
   void saveProfiles();
 };
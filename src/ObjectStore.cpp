@@ -0,0 +1,142 @@
+#include "ObjectStore.h"
+
+#include <openssl/evp.h>
+#include <spdlog/spdlog.h>
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+ObjectStore &ObjectStore::instance() {
+  static ObjectStore store;
+  return store;
+}
+
+void ObjectStore::setRoot(const std::string &root) {
+  std::lock_guard<std::mutex> lk(m_mtx);
+  m_root = root;
+  std::error_code ec;
+  fs::create_directories(m_root, ec);
+}
+
+bool ObjectStore::enabled() const {
+  std::lock_guard<std::mutex> lk(m_mtx);
+  return !m_root.empty();
+}
+
+std::string ObjectStore::objectPath(const std::string &sha1) const {
+  std::lock_guard<std::mutex> lk(m_mtx);
+  if (m_root.empty() || sha1.size() < 2)
+    return {};
+  return m_root + "/" + sha1.substr(0, 2) + "/" + sha1;
+}
+
+bool ObjectStore::contains(const std::string &sha1) const {
+  std::string obj = objectPath(sha1);
+  std::error_code ec;
+  return !obj.empty() && fs::is_regular_file(obj, ec);
+}
+
+bool ObjectStore::materialize(const std::string &sha1,
+                              const std::string &dest) {
+  std::string obj = objectPath(sha1);
+  if (obj.empty())
+    return false;
+  std::error_code ec;
+  fs::create_directories(fs::path(dest).parent_path(), ec);
+  return linkFile(obj, dest, true);
+}
+
+void ObjectStore::adopt(const std::string &path, const std::string &sha1) {
+  std::string obj = objectPath(sha1);
+  if (obj.empty())
+    return;
+  std::error_code ec;
+  if (fs::is_regular_file(obj, ec)) {
+    // Aynı içerik başka bir kopya olarak duruyor: depodakine bağla
+    linkFile(obj, path, false);
+    return;
+  }
+  fs::create_directories(fs::path(obj).parent_path(), ec);
+  linkFile(path, obj, false);
+}
+
+// from'u to'ya bağlar; önce geçici ada, sonra rename ile atomik olarak.
+// Sıra: reflink (CoW, bağımsız kopya) -> hardlink -> (izinliyse) kopya.
+bool ObjectStore::linkFile(const std::string &from, const std::string &to,
+                           bool allowCopy) {
+  std::error_code ec;
+  if (fs::exists(to, ec) && fs::equivalent(from, to, ec))
+    return true;
+
+  static std::atomic<unsigned> seq{0};
+  std::string tmp = to + ".link" + std::to_string(seq.fetch_add(1));
+  fs::remove(tmp, ec);
+
+  bool linked = false;
+#ifdef __linux__
+  int src = ::open(from.c_str(), O_RDONLY | O_CLOEXEC);
+  if (src >= 0) {
+    int dst = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC,
+                     0644);
+    if (dst >= 0) {
+      linked = ::ioctl(dst, FICLONE, src) == 0;
+      ::close(dst);
+      if (!linked)
+        fs::remove(tmp, ec);
+    }
+    ::close(src);
+  }
+#endif
+  if (!linked) {
+    fs::create_hard_link(from, tmp, ec);
+    linked = !ec;
+  }
+  if (!linked && allowCopy) {
+    linked = fs::copy_file(from, tmp, fs::copy_options::overwrite_existing,
+                           ec) &&
+             !ec;
+  }
+  if (!linked)
+    return false;
+
+  fs::rename(tmp, to, ec);
+  if (ec) {
+    spdlog::warn("Depo baglantisi tasinamadi: {} ({})", to, ec.message());
+    fs::remove(tmp, ec);
+    return false;
+  }
+  return true;
+}
+
+std::string ObjectStore::sha1File(const std::string &path) {
+  std::ifstream ifs(path, std::ios::binary);
+  if (!ifs)
+    return {};
+  EVP_MD_CTX *ctx = EVP_MD_CTX_new();
+  EVP_DigestInit_ex(ctx, EVP_sha1(), nullptr);
+  char buf[16384];
+  while (ifs.read(buf, sizeof(buf)))
+    EVP_DigestUpdate(ctx, buf, ifs.gcount());
+  if (ifs.gcount() > 0)
+    EVP_DigestUpdate(ctx, buf, ifs.gcount());
+  unsigned char hash[EVP_MAX_MD_SIZE];
+  unsigned int hlen = 0;
+  EVP_DigestFinal_ex(ctx, hash, &hlen);
+  EVP_MD_CTX_free(ctx);
+  std::ostringstream ss;
+  for (unsigned int i = 0; i < hlen; ++i)
+    ss << std::hex << std::setfill('0') << std::setw(2) << (int)hash[i];
+  return ss.str();
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <mutex>
+#include <string>
+
+// Profiller arası paylaşılan içerik adresli dosya deposu:
+//   <mcDir>/store/<sha1[0:2]>/<sha1>
+// Aynı mod/kütüphane her profile yeniden indirilip kopyalanmaz; hedef
+// dosya depodaki nesneye reflink (FICLONE, CoW) ya da hardlink olarak
+// bağlanır. Depoya yalnızca hash'i doğrulanmış dosyalar girer.
+class ObjectStore {
+public:
+  static ObjectStore &instance();
+
+  // Depo kökü (ör. <mcDir>/store). Ayarlanmazsa depo devre dışı.
+  void setRoot(const std::string &root);
+  bool enabled() const;
+
+  std::string objectPath(const std::string &sha1) const;
+  bool contains(const std::string &sha1) const;
+
+  // Depodaki nesneyi dest'e bağla (reflink -> hardlink -> kopya)
+  bool materialize(const std::string &sha1, const std::string &dest);
+
+  // Doğrulanmış dosyayı depoya al. Nesne zaten varsa path ona bağlanarak
+  // çift kopya kaldırılır. Yalnızca bağlantı kurulur, kopyalanmaz.
+  void adopt(const std::string &path, const std::string &sha1);
+
+  // Dosyanın SHA-1'i (hex); okunamazsa boş
+  static std::string sha1File(const std::string &path);
+
+private:
+  ObjectStore() = default;
+
+  static bool linkFile(const std::string &from, const std::string &to,
+                       bool allowCopy);
+
+  mutable std::mutex m_mtx;
+  std::string m_root;
+};
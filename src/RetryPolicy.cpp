@@ -0,0 +1,95 @@
+#include "RetryPolicy.h"
+
+#include <algorithm>
+#include <iostream>
+
+using namespace std::chrono;
+
+milliseconds RetryPolicy::backoff(int attempt, long retryAfterSec) {
+  // 500 ms, 1 s, 2 s, ... en fazla 30 s; yarısı sabit, yarısı rastgele
+  long long base = 500LL << std::clamp(attempt, 0, 6);
+  base = std::min(base, 30000LL);
+  long long jitter;
+  {
+    std::lock_guard<std::mutex> lk(m_mtx);
+    jitter = std::uniform_int_distribution<long long>(0, base / 2)(m_rng);
+  }
+  long long delay = base / 2 + jitter;
+  if (retryAfterSec > 0)
+    delay = std::max(delay, std::min(retryAfterSec, 300L) * 1000LL);
+  return milliseconds(delay);
+}
+
+RetryPolicy::Verdict RetryPolicy::check(const std::string &host,
+                                        Clock::time_point &retryAt) {
+  std::lock_guard<std::mutex> lk(m_mtx);
+  auto it = m_hosts.find(host);
+  if (it == m_hosts.end() || it->second.trips == 0)
+    return Verdict::Allow;
+  HostState &st = it->second;
+  auto now = Clock::now();
+  // Çökmüş host: süre dolana kadar başarısız, sonra half-open yoklama
+  if (st.trips > kMaxTrips && now < st.openUntil)
+    return Verdict::Fail;
+  if (now < st.openUntil) {
+    retryAt = st.openUntil;
+    return Verdict::Defer;
+  }
+  // Half-open: sonuç gelene kadar yalnızca bir istek geçer
+  if (st.probing) {
+    retryAt = now + seconds(1);
+    return Verdict::Defer;
+  }
+  st.probing = true;
+  return Verdict::Allow;
+}
+
+void RetryPolicy::onSuccess(const std::string &host) {
+  std::lock_guard<std::mutex> lk(m_mtx);
+  auto it = m_hosts.find(host);
+  if (it != m_hosts.end())
+    m_hosts.erase(it);
+}
+
+void RetryPolicy::onFailure(const std::string &host) {
+  std::lock_guard<std::mutex> lk(m_mtx);
+  auto &st = m_hosts[host];
+  st.probing = false;
+  if (++st.consecutiveFailures < kTripThreshold)
+    return;
+
+  // Süre dolunca gelen ilk hata devreyi yeniden açar
+  st.consecutiveFailures = kTripThreshold - 1;
+  if (++st.trips > kMaxTrips) {
+    st.openUntil = Clock::now() + kDownCooldown;
+    std::cerr << "[DEVRE] " << host << " erisilemiyor, "
+              << kDownCooldown.count() << " sn boyunca gorevler basarisiz"
+              << std::endl;
+    return;
+  }
+  // Devreyi aç: 5 s, 10 s, 20 s ... en fazla 2 dk
+  auto cooldown = seconds(std::min(5 << std::min(st.trips - 1, 5), 120));
+  st.openUntil = Clock::now() + cooldown;
+  std::cerr << "[DEVRE] " << host << " " << cooldown.count()
+            << " sn boyunca atlanacak" << std::endl;
+}
+
+void RetryPolicy::onAbandoned(const std::string &host) {
+  std::lock_guard<std::mutex> lk(m_mtx);
+  auto it = m_hosts.find(host);
+  if (it != m_hosts.end())
+    it->second.probing = false;
+}
+
+void RetryPolicy::reset() {
+  std::lock_guard<std::mutex> lk(m_mtx);
+  m_hosts.clear();
+}
+
+std::string RetryPolicy::hostOf(const std::string &url) {
+  auto start = url.find("://");
+  start = (start == std::string::npos) ? 0 : start + 3;
+  auto end = url.find_first_of("/?#", start);
+  return url.substr(start, end == std::string::npos ? std::string::npos
+                                                    : end - start);
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <chrono>
+#include <mutex>
+#include <random>
+#include <string>
+#include <unordered_map>
+
+// Geçici hatalar için yeniden deneme politikası:
+//  - üstel geri çekilme + jitter (Retry-After varsa ona uyulur)
+//  - host başına devre kesici: art arda hata veren host'a bir süre istek
+//    gönderilmez, süre dolunca tek bir deneme geçer (half-open). Devre
+//    kMaxTrips kez açılan host kDownCooldown boyunca çökmüş sayılır
+//    (görevleri beklemeden başarısız olur); süre dolunca yeniden yoklanır.
+class RetryPolicy {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  // attempt: 0'dan başlayan deneme numarası, retryAfterSec: sunucu başlığı
+  std::chrono::milliseconds backoff(int attempt, long retryAfterSec = 0);
+
+  enum class Verdict { Allow, Defer, Fail };
+
+  // Defer: devre açık, retryAt'te yeniden dene. Fail: host çökmüş.
+  Verdict check(const std::string &host, Clock::time_point &retryAt);
+  void onSuccess(const std::string &host);
+  void onFailure(const std::string &host);
+  // Transfer sonuçsuz bırakıldı (iptal, kapanış, kardeşi başarısız parça):
+  // half-open denemesi serbest kalır, sayaçlar değişmez
+  void onAbandoned(const std::string &host);
+  void reset(); // Yeni oturum: tüm host durumlarını unut
+
+  static std::string hostOf(const std::string &url);
+
+private:
+  struct HostState {
+    int consecutiveFailures = 0;
+    int trips = 0; // Devrenin kaç kez açıldığı (bekleme süresi katlanır)
+    Clock::time_point openUntil{};
+    bool probing = false; // Half-open: tek bir deneme isteği uçuşta
+  };
+
+  static constexpr int kTripThreshold = 5;
+  static constexpr int kMaxTrips = 3; // 5+10+20 sn kapalı kaldıktan sonra
+  static constexpr std::chrono::seconds kDownCooldown{60};
+
+  std::mutex m_mtx;
+  std::unordered_map<std::string, HostState> m_hosts;
+  std::mt19937 m_rng{std::random_device{}()};
+};
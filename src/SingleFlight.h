@@ -0,0 +1,92 @@
+#pragma once
+
+#include "CancelToken.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// Aynı anahtar (URL ya da hedef dosya) için eşzamanlı çağrıları tek
+// uçuşa indirger: ilk gelen (lider) işi yapar, uçuş sürerken gelenler
+// onun sonucunu bekleyip paylaşır. Uçuş bitince anahtar silinir; sonraki
+// çağrı işi yeniden yapar (önbellek değildir).
+//
+// Lider iptal edildiyse yarım sonucu yalnızca kendisi alır, iptal
+// edilmemiş bekleyenler işi yeniden dener. Bekleyenin kendi token'ı
+// kurulursa beklemeyi bırakır ve T{} döner.
+template <class T> class SingleFlight {
+public:
+  template <class Fn>
+  T run(const std::string &key, Fn &&fn, const CancelToken *cancel = nullptr) {
+    for (;;) {
+      std::shared_ptr<Flight> flight;
+      bool leader = false;
+      {
+        std::lock_guard<std::mutex> lk(m_mtx);
+        auto &slot = m_flights[key];
+        if (!slot) {
+          slot = std::make_shared<Flight>();
+          leader = true;
+        }
+        flight = slot;
+      }
+      if (leader)
+        return lead(key, *flight, fn, cancel);
+
+      std::unique_lock<std::mutex> lk(flight->mtx);
+      while (!flight->done) {
+        if (cancel && cancel->cancelled())
+          return T{};
+        flight->cv.wait_for(lk, std::chrono::milliseconds(100));
+      }
+      if (flight->error)
+        std::rethrow_exception(flight->error);
+      if (!flight->aborted)
+        return flight->value;
+    }
+  }
+
+private:
+  struct Flight {
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool done = false;
+    bool aborted = false; // Lider iptal edildi: sonuç paylaşılmaz
+    T value{};
+    std::exception_ptr error;
+  };
+
+  template <class Fn>
+  T lead(const std::string &key, Flight &flight, Fn &fn,
+         const CancelToken *cancel) {
+    T value{};
+    std::exception_ptr error;
+    try {
+      value = fn();
+    } catch (...) {
+      error = std::current_exception();
+    }
+    {
+      std::lock_guard<std::mutex> lk(m_mtx);
+      m_flights.erase(key);
+    }
+    {
+      std::lock_guard<std::mutex> lk(flight.mtx);
+      flight.done = true;
+      flight.aborted = cancel && cancel->cancelled();
+      flight.value = value;
+      flight.error = error;
+    }
+    flight.cv.notify_all();
+    if (error)
+      std::rethrow_exception(error);
+    return value;
+  }
+
+  std::mutex m_mtx;
+  std::unordered_map<std::string, std::shared_ptr<Flight>> m_flights;
+};
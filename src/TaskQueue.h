@@ -0,0 +1,65 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+// Bloklayan öncelik kuyruğu: sınıf başına bir FIFO, tek mutex + cv.
+// pop en yüksek öncelikli (en küçük indeksli) sınıftan alır. push tek
+// tüketici uyandırır; wakeAll iptal/kapanışta hepsini uyandırır.
+template <class T, int Classes> class TaskQueue {
+public:
+  void push(int cls, T value) {
+    cls = std::clamp(cls, 0, Classes - 1);
+    {
+      std::lock_guard<std::mutex> lk(m_mtx);
+      m_queues[cls].push_back(std::move(value));
+    }
+    m_cv.notify_one();
+  }
+
+  // waitMs: <0 sonsuza dek, 0 beklemeden. stop true olunca boş döner.
+  bool pop(T &out, int waitMs, const std::atomic<bool> &stop) {
+    std::unique_lock<std::mutex> lk(m_mtx);
+    auto ready = [&] { return !emptyLocked() || stop.load(); };
+    if (waitMs < 0)
+      m_cv.wait(lk, ready);
+    else if (waitMs > 0)
+      m_cv.wait_for(lk, std::chrono::milliseconds(waitMs), ready);
+    if (stop.load())
+      return false;
+    return popLocked(out);
+  }
+
+  // Bekleyen tüm tüketicileri uyandır (iptal/kapanış)
+  void wakeAll() {
+    std::lock_guard<std::mutex> lk(m_mtx);
+    m_cv.notify_all();
+  }
+
+private:
+  bool emptyLocked() const {
+    for (const auto &q : m_queues)
+      if (!q.empty())
+        return false;
+    return true;
+  }
+
+  bool popLocked(T &out) {
+    for (auto &q : m_queues) {
+      if (!q.empty()) {
+        out = std::move(q.front());
+        q.pop_front();
+        return true;
+      }
+    }
+    return false;
+  }
+
+  std::deque<T> m_queues[Classes];
+  std::mutex m_mtx;
+  std::condition_variable m_cv;
+};
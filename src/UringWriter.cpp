@@ -0,0 +1,385 @@
+#include "UringWriter.h"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+// Doğrudan (registered) dosya tanımlayıcıları ile openat/close: 5.15+
+#ifdef IORING_FILE_INDEX_ALLOC
+#define MIXLAUNCHER_IO_URING 1
+#endif
+#endif
+
+#ifdef MIXLAUNCHER_IO_URING
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#endif
+
+namespace fs = std::filesystem;
+
+// Bellekte bekleyen gövdeler için sınırlar
+static constexpr size_t kMaxBatchFiles = 128;
+static constexpr size_t kMaxBatchBytes = 8u << 20;
+static constexpr auto kMaxAge = std::chrono::milliseconds(100);
+
+#ifdef MIXLAUNCHER_IO_URING
+// liburing'e bağımlı olmamak için halkalar doğrudan mmap edilir
+struct UringWriter::Ring {
+  int fd = -1;
+  unsigned entries = 0;
+  unsigned slots = 0; // Kayıtlı dosya tablosu boyutu
+
+  void *sqMap = MAP_FAILED;
+  size_t sqMapLen = 0;
+  void *cqMap = MAP_FAILED;
+  size_t cqMapLen = 0;
+  io_uring_sqe *sqes = nullptr;
+  size_t sqesLen = 0;
+
+  unsigned *sqTail = nullptr;
+  unsigned *sqMask = nullptr;
+  unsigned *sqArray = nullptr;
+  unsigned *cqHead = nullptr;
+  unsigned *cqTail = nullptr;
+  unsigned *cqMask = nullptr;
+  io_uring_cqe *cqes = nullptr;
+
+  unsigned tail = 0;   // Henüz yayınlanmamış SQ kuyruğu
+  unsigned queued = 0; // Bu turda hazırlanan SQE sayısı
+
+  ~Ring() {
+    if (sqes)
+      ::munmap(sqes, sqesLen);
+    if (cqMap != MAP_FAILED && cqMap != sqMap)
+      ::munmap(cqMap, cqMapLen);
+    if (sqMap != MAP_FAILED)
+      ::munmap(sqMap, sqMapLen);
+    if (fd >= 0)
+      ::close(fd);
+  }
+
+  io_uring_sqe *next() {
+    unsigned idx = tail & *sqMask;
+    sqArray[idx] = idx;
+    io_uring_sqe *sqe = &sqes[idx];
+    std::memset(sqe, 0, sizeof(*sqe));
+    ++tail;
+    ++queued;
+    return sqe;
+  }
+
+  // Hazırlanan SQE'leri gönderir ve hepsi tamamlanana dek bekler.
+  // false: halka kullanılamaz durumda.
+  template <class OnCqe> bool run(OnCqe &&onCqe) {
+    __atomic_store_n(sqTail, tail, __ATOMIC_RELEASE);
+    unsigned n = queued;
+    unsigned submitted = 0;
+    unsigned reaped = 0;
+    queued = 0;
+    while (reaped < n) {
+      int r = static_cast<int>(::syscall(__NR_io_uring_enter, fd,
+                                         n - submitted, 1,
+                                         IORING_ENTER_GETEVENTS, nullptr, 0));
+      if (r < 0) {
+        if (errno == EINTR || errno == EAGAIN || errno == EBUSY)
+          continue;
+        return false;
+      }
+      submitted += static_cast<unsigned>(r);
+
+      unsigned head = *cqHead;
+      unsigned ctail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+      for (; head != ctail; ++head, ++reaped)
+        onCqe(cqes[head & *cqMask]);
+      __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+    }
+    return true;
+  }
+};
+
+static bool opSupported(const io_uring_probe *probe, int op) {
+  return op <= probe->last_op &&
+         (probe->ops[op].flags & IO_URING_OP_SUPPORTED);
+}
+
+std::unique_ptr<UringWriter> UringWriter::create(unsigned entries) {
+  auto ring = std::make_unique<Ring>();
+  io_uring_params params{};
+  ring->fd =
+      static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+  if (ring->fd < 0) {
+    spdlog::info("io_uring kullanilamiyor ({}), senkron yazim",
+                 std::strerror(errno));
+    return nullptr;
+  }
+  ring->entries = params.sq_entries;
+
+  // Gereken işlemler: mkdirat, openat, write, close
+  std::vector<char> probeBuf(sizeof(io_uring_probe) +
+                             256 * sizeof(io_uring_probe_op));
+  auto *probe = reinterpret_cast<io_uring_probe *>(probeBuf.data());
+  if (::syscall(__NR_io_uring_register, ring->fd, IORING_REGISTER_PROBE,
+                probe, 256) < 0 ||
+      !opSupported(probe, IORING_OP_MKDIRAT) ||
+      !opSupported(probe, IORING_OP_OPENAT) ||
+      !opSupported(probe, IORING_OP_WRITE) ||
+      !opSupported(probe, IORING_OP_CLOSE)) {
+    spdlog::info("io_uring gerekli islemleri desteklemiyor, senkron yazim");
+    return nullptr;
+  }
+
+  // Dosya başına üç SQE; boş (-1) doğrudan tanımlayıcı yuvaları
+  ring->slots = ring->entries / 3;
+  std::vector<int> empty(ring->slots, -1);
+  if (::syscall(__NR_io_uring_register, ring->fd, IORING_REGISTER_FILES,
+                empty.data(), ring->slots) < 0) {
+    spdlog::info("io_uring dosya tablosu kaydedilemedi, senkron yazim");
+    return nullptr;
+  }
+
+  ring->sqMapLen = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  ring->cqMapLen =
+      params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+  if (single)
+    ring->sqMapLen = ring->cqMapLen = std::max(ring->sqMapLen, ring->cqMapLen);
+  ring->sqMap = ::mmap(nullptr, ring->sqMapLen, PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+  if (ring->sqMap == MAP_FAILED)
+    return nullptr;
+  ring->cqMap = single ? ring->sqMap
+                       : ::mmap(nullptr, ring->cqMapLen,
+                                PROT_READ | PROT_WRITE,
+                                MAP_SHARED | MAP_POPULATE, ring->fd,
+                                IORING_OFF_CQ_RING);
+  if (ring->cqMap == MAP_FAILED)
+    return nullptr;
+  ring->sqesLen = params.sq_entries * sizeof(io_uring_sqe);
+  void *sqes = ::mmap(nullptr, ring->sqesLen, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+  if (sqes == MAP_FAILED)
+    return nullptr;
+  ring->sqes = static_cast<io_uring_sqe *>(sqes);
+
+  auto *sq = static_cast<char *>(ring->sqMap);
+  auto *cq = static_cast<char *>(ring->cqMap);
+  ring->sqTail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+  ring->sqMask = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+  ring->sqArray = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+  ring->cqHead = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+  ring->cqTail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+  ring->cqMask = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+  ring->cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+  ring->tail = *ring->sqTail;
+
+  return std::unique_ptr<UringWriter>(new UringWriter(std::move(ring)));
+}
+#else
+struct UringWriter::Ring {};
+
+std::unique_ptr<UringWriter> UringWriter::create(unsigned) { return nullptr; }
+#endif
+
+UringWriter::UringWriter(std::unique_ptr<Ring> ring)
+    : m_ring(std::move(ring)) {}
+
+UringWriter::~UringWriter() { flush(); }
+
+void UringWriter::assumeDirs(const std::vector<std::string> &dirs) {
+  for (const auto &d : dirs)
+    rememberDir(d);
+}
+
+void UringWriter::add(std::string path, std::string data, Done done) {
+  if (m_pending.empty())
+    m_oldest = std::chrono::steady_clock::now();
+  m_pendingBytes += data.size();
+  m_pending.push_back({std::move(path), std::move(data), std::move(done)});
+}
+
+bool UringWriter::due(bool idle) const {
+  if (m_pending.empty())
+    return false;
+  return idle || m_pending.size() >= kMaxBatchFiles ||
+         m_pendingBytes >= kMaxBatchBytes ||
+         std::chrono::steady_clock::now() - m_oldest >= kMaxAge;
+}
+
+void UringWriter::flush() {
+  if (m_pending.empty())
+    return;
+  std::vector<Entry> batch;
+  batch.swap(m_pending);
+  m_pendingBytes = 0;
+
+  std::vector<bool> ok(batch.size(), false);
+  makeDirs(batch);
+#ifdef MIXLAUNCHER_IO_URING
+  size_t per = std::max<size_t>(1, m_ring->slots);
+  for (size_t first = 0; first < batch.size() && !m_broken; first += per)
+    writeBatch(batch, first, std::min(batch.size(), first + per), ok);
+#endif
+
+  for (size_t i = 0; i < batch.size(); ++i) {
+    // Halka dışı hata (ör. kısa yazım): aynı dosyayı senkron yaz
+    if (!ok[i])
+      ok[i] = writeSync(batch[i].path, batch[i].data);
+    if (batch[i].done)
+      batch[i].done(ok[i]);
+  }
+}
+
+void UringWriter::rememberDir(const std::string &dir) {
+  for (fs::path p(dir); !p.empty() && p != p.root_path(); p = p.parent_path())
+    if (!m_dirs.insert(p.string()).second)
+      break;
+}
+
+void UringWriter::makeDirs(const std::vector<Entry> &batch) {
+  std::vector<std::string> viaRing;
+  for (const auto &e : batch) {
+    std::string dir = fs::path(e.path).parent_path().string();
+    if (dir.empty() || m_dirs.count(dir) ||
+        std::find(viaRing.begin(), viaRing.end(), dir) != viaRing.end())
+      continue;
+    // Üst dizin biliniyorsa tek mkdirat yeter; değilse zinciri bir kez
+    // senkron kur (ör. ilk objects/xx)
+    std::string parent = fs::path(dir).parent_path().string();
+    if (!m_broken && m_dirs.count(parent)) {
+      viaRing.push_back(dir);
+      continue;
+    }
+    std::error_code ec;
+    fs::create_directories(dir, ec);
+    if (!ec)
+      rememberDir(dir);
+  }
+
+#ifdef MIXLAUNCHER_IO_URING
+  std::vector<int> res(viaRing.size(), -1);
+  for (size_t first = 0; first < viaRing.size() && !m_broken;
+       first += m_ring->entries) {
+    size_t last = std::min(viaRing.size(), first + m_ring->entries);
+    for (size_t i = first; i < last; ++i) {
+      io_uring_sqe *sqe = m_ring->next();
+      sqe->opcode = IORING_OP_MKDIRAT;
+      sqe->fd = AT_FDCWD;
+      sqe->addr = reinterpret_cast<__u64>(viaRing[i].c_str());
+      sqe->len = 0755;
+      sqe->user_data = i;
+    }
+    m_broken = !m_ring->run([&](const io_uring_cqe &cqe) {
+      res[cqe.user_data] = cqe.res;
+    });
+  }
+  for (size_t i = 0; i < viaRing.size(); ++i) {
+    if (res[i] == 0 || res[i] == -EEXIST) {
+      m_dirs.insert(viaRing[i]);
+      continue;
+    }
+    std::error_code ec;
+    fs::create_directories(viaRing[i], ec);
+    if (!ec)
+      rememberDir(viaRing[i]);
+  }
+#endif
+}
+
+void UringWriter::writeBatch(const std::vector<Entry> &batch, size_t first,
+                             size_t last, std::vector<bool> &ok) {
+#ifdef MIXLAUNCHER_IO_URING
+  // Dosya başına openat -> write -> close. write, close'a "hard" bağlıdır:
+  // kısa/hatalı yazımda da yuva kapatılır.
+  enum : __u64 { kOpen = 0, kWrite = 1, kClose = 2 };
+  struct Result {
+    int open = -ECANCELED;
+    int write = -ECANCELED;
+    int close = -ECANCELED;
+  };
+  std::vector<Result> results(last - first);
+  for (size_t i = first; i < last; ++i) {
+    const Entry &e = batch[i];
+    auto slot = static_cast<__u32>(i - first);
+    __u64 tag = static_cast<__u64>(i - first) << 2;
+
+    io_uring_sqe *sqe = m_ring->next();
+    sqe->opcode = IORING_OP_OPENAT;
+    sqe->fd = AT_FDCWD;
+    sqe->addr = reinterpret_cast<__u64>(e.path.c_str());
+    sqe->len = 0644;
+    // Doğrudan tanımlayıcıda O_CLOEXEC geçersiz (EINVAL); fd tabloya girmez
+    sqe->open_flags = O_WRONLY | O_CREAT | O_TRUNC;
+    sqe->file_index = slot + 1;
+    sqe->flags = IOSQE_IO_LINK;
+    sqe->user_data = tag | kOpen;
+
+    if (!e.data.empty()) {
+      sqe = m_ring->next();
+      sqe->opcode = IORING_OP_WRITE;
+      sqe->fd = static_cast<__s32>(slot);
+      sqe->addr = reinterpret_cast<__u64>(e.data.data());
+      sqe->len = static_cast<__u32>(e.data.size());
+      sqe->off = 0;
+      sqe->flags = IOSQE_FIXED_FILE | IOSQE_IO_HARDLINK;
+      sqe->user_data = tag | kWrite;
+    } else {
+      results[i - first].write = 0;
+    }
+
+    sqe = m_ring->next();
+    sqe->opcode = IORING_OP_CLOSE;
+    sqe->file_index = slot + 1;
+    sqe->user_data = tag | kClose;
+  }
+
+  m_broken = !m_ring->run([&](const io_uring_cqe &cqe) {
+    Result &r = results[cqe.user_data >> 2];
+    switch (cqe.user_data & 3) {
+    case kOpen:
+      r.open = cqe.res;
+      break;
+    case kWrite:
+      r.write = cqe.res;
+      break;
+    default:
+      r.close = cqe.res;
+      break;
+    }
+  });
+  if (m_broken) {
+    spdlog::warn("io_uring gonderimi basarisiz, senkron yazima donuluyor");
+    return;
+  }
+
+  for (size_t i = first; i < last; ++i) {
+    const Result &r = results[i - first];
+    ok[i] = r.open == 0 && r.close == 0 &&
+            r.write == static_cast<int>(batch[i].data.size());
+  }
+#else
+  (void)batch;
+  (void)first;
+  (void)last;
+  (void)ok;
+#endif
+}
+
+bool UringWriter::writeSync(const std::string &path, const std::string &data) {
+  std::error_code ec;
+  fs::create_directories(fs::path(path).parent_path(), ec);
+  std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+  if (!ofs)
+    return false;
+  ofs.write(data.data(), static_cast<std::streamsize>(data.size()));
+  ofs.close();
+  return static_cast<bool>(ofs);
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+// Küçük dosya fırtınaları için toplu yazıcı (Linux io_uring). Gövdesi
+// bellekte tamamlanmış dosyalar biriktirilir; flush'ta eksik dizinler için
+// mkdirat, ardından dosya başına bağlı openat -> write -> close zincirleri
+// tek io_uring_enter ile gönderilir. Dosya başına dört senkron syscall
+// yerine birkaç toplu çağrı yapılır; hash akış sırasında hesaplandığından
+// dosya yeniden okunmaz.
+//
+// Bir event-loop'a aittir; thread-safe değildir. Çekirdek io_uring'i ya da
+// gereken işlemleri desteklemiyorsa (eski çekirdek, seccomp, Linux dışı)
+// create() nullptr döner ve çağıran FileSink yoluna devam eder.
+class UringWriter {
+public:
+  using Done = std::function<void(bool ok)>;
+
+  static std::unique_ptr<UringWriter> create(unsigned entries = 256);
+  ~UringWriter();
+
+  UringWriter(const UringWriter &) = delete;
+  UringWriter &operator=(const UringWriter &) = delete;
+
+  // Var olduğu bilinen dizinler (ör. kurulum planında oluşturulanlar):
+  // bunlar için mkdirat gönderilmez
+  void assumeDirs(const std::vector<std::string> &dirs);
+
+  // data, path'e (truncate) yazılır. done, flush'ta çağrılır.
+  void add(std::string path, std::string data, Done done);
+
+  // Toplu iş doldu, yeterince bekledi ya da çağıran boşta (idle)
+  bool due(bool idle) const;
+  void flush();
+
+  size_t pending() const { return m_pending.size(); }
+
+private:
+  struct Ring;
+  struct Entry {
+    std::string path;
+    std::string data;
+    Done done;
+  };
+
+  explicit UringWriter(std::unique_ptr<Ring> ring);
+
+  void makeDirs(const std::vector<Entry> &batch);
+  void rememberDir(const std::string &dir);
+  // [first, last) dosyalarını yazar; her birinin sonucunu ok'a yazar
+  void writeBatch(const std::vector<Entry> &batch, size_t first, size_t last,
+                  std::vector<bool> &ok);
+  static bool writeSync(const std::string &path, const std::string &data);
+
+  std::unique_ptr<Ring> m_ring;
+  bool m_broken = false; // Ring hata verdi: yalnızca senkron yazılır
+  std::vector<Entry> m_pending;
+  size_t m_pendingBytes = 0;
+  std::chrono::steady_clock::time_point m_oldest{};
+  std::unordered_set<std::string> m_dirs; // Var olduğu bilinen dizinler
+};